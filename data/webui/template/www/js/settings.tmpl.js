@@ -137,8 +137,13 @@ setInputValue(current_cpm_enabled == 1, "cpm-virt-yes", "cpm-virt-no");
 {% if components.serial_port %}
 setSerialCommand(current_serial_command);
 setSerialProceed(current_serial_proceed);
+setInputValue(current_serial_precise_timing == 1, "precise-timing-yes", "precise-timing-no");
 {% endif %}
 
 {% if components.emulator_settings %}
 setInputValue(current_netsio_enabled == 1, "netsio-yes", "netsio-no");
 {% endif %}
+
+{% if components.boip_settings %}
+setInputValue(current_boip_udp == 0, "boip-tcp", "boip-udp");
+{% endif %}
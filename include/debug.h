@@ -16,13 +16,15 @@
 
 #if defined(DEBUG) || !defined(NO_DEBUG_PRINT)
 #include <utils.h>
+#include <debug_log.h>
 /*
   Debugging Macros
+  Messages are dropped early if disabled for subsystem of the source file (see debug_log.h)
 */
-    #define Debug_print(...) util_debug_printf(nullptr, __VA_ARGS__)
-    #define Debug_printf(...) util_debug_printf(__VA_ARGS__)
-    #define Debug_println(...) util_debug_printf("%s\n", __VA_ARGS__)
-    #define Debug_printv(format, ...) {util_debug_printf( ANSI_YELLOW "[%s:%u] %s(): " ANSI_GREEN_BOLD format ANSI_RESET "\r\n", __FILE__, __LINE__, __FUNCTION__, ##__VA_ARGS__);}
+    #define Debug_print(...) do { if (util_debug_enabled(DEBUG_SUBSYS, DEBUG_LEVEL_INFO)) util_debug_printf(nullptr, __VA_ARGS__); } while (0)
+    #define Debug_printf(...) do { if (util_debug_enabled(DEBUG_SUBSYS, DEBUG_LEVEL_INFO)) util_debug_printf(__VA_ARGS__); } while (0)
+    #define Debug_println(...) do { if (util_debug_enabled(DEBUG_SUBSYS, DEBUG_LEVEL_INFO)) util_debug_printf("%s\n", __VA_ARGS__); } while (0)
+    #define Debug_printv(format, ...) do { if (util_debug_enabled(DEBUG_SUBSYS, DEBUG_LEVEL_VERBOSE)) util_debug_printf( ANSI_YELLOW "[%s:%u] %s(): " ANSI_GREEN_BOLD format ANSI_RESET "\r\n", __FILE__, __LINE__, __FUNCTION__, ##__VA_ARGS__); } while (0)
 
     #define HEAP_CHECK(x) Debug_printf("HEAP CHECK %s " x "\r\n", heap_caps_check_integrity_all(true) ? "PASSED":"FAILED")
 #else
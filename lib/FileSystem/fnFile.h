@@ -2,6 +2,7 @@
 #define _FN_FILE_
 
 #include <stdio.h>
+#include <stdint.h>
 
 
 /* 
@@ -21,6 +22,12 @@ public:
     virtual size_t read(void *ptr, size_t size, size_t n) = 0;
     virtual size_t write(const void *ptr, size_t size, size_t n) = 0;
     virtual int flush() = 0;
+
+    // view of the whole file, nullptr if the handler can't provide one (remote files)
+    // writes to writable view go to the file, flush() makes them durable
+    // valid until munmap_view() or close()
+    virtual uint8_t *mmap_view(size_t *size, bool writable = false) { return nullptr; }
+    virtual void munmap_view() {}
 };
 
 
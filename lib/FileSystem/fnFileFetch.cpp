@@ -0,0 +1,317 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "fnFileFetch.h"
+#include "../../include/debug.h"
+
+
+FileHandlerFetch::FileHandlerFetch(FileHandler *fh, long int size, bool write_back, FileSystem *spill_fs, const char *spill_path)
+    : _fh(fh), _size(size), _write_back(write_back)
+{
+    Debug_printf("new FileHandlerFetch, size %ld\n", size);
+
+    if (spill_fs != nullptr && spill_path != nullptr)
+    {
+        _spill = spill_fs->file_open(spill_path, "wb+");
+        if (_spill != nullptr)
+        {
+            _spill_fs = spill_fs;
+            _spill_path = spill_path;
+        }
+    }
+    if (_spill == nullptr && size <= FETCH_MEM_MAXSIZE)
+        _buffer = (uint8_t *)malloc(size > 0 ? size : 1);
+
+    if (!has_copy())
+    {
+        Debug_println("FileHandlerFetch: no space for copy, reading file directly");
+        return;
+    }
+
+    _missing = (size + FETCH_BLOCK_SIZE - 1) / FETCH_BLOCK_SIZE;
+    _present.assign(_missing, 0);
+    _thread = std::thread(&FileHandlerFetch::fetch_loop, this);
+}
+
+
+FileHandlerFetch::~FileHandlerFetch()
+{
+    Debug_println("delete FileHandlerFetch");
+    if (_fh != nullptr) close(false);
+}
+
+
+int FileHandlerFetch::close(bool destroy)
+{
+    Debug_println("FileHandlerFetch::close");
+    int result = 0;
+
+    if (_thread.joinable())
+    {
+        _stop = true;
+        _thread.join();
+    }
+
+    free(_buffer);
+    _buffer = nullptr;
+    if (_spill != nullptr)
+    {
+        fclose(_spill);
+        _spill = nullptr;
+        _spill_fs->remove(_spill_path.c_str());
+    }
+
+    if (_fh != nullptr)
+    {
+        result = _fh->close();
+        _fh = nullptr;
+    }
+    if (destroy) delete this;
+    return result;
+}
+
+
+int FileHandlerFetch::seek(long int off, int whence)
+{
+    Debug_println("FileHandlerFetch::seek");
+    switch (whence)
+    {
+    case SEEK_SET:
+        break;
+    case SEEK_CUR:
+        off += _position;
+        break;
+    case SEEK_END:
+        off += _size;
+        break;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+    if (off < 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    _position = off;
+    return 0;
+}
+
+
+long int FileHandlerFetch::tell()
+{
+    Debug_println("FileHandlerFetch::tell");
+    return _position;
+}
+
+
+size_t FileHandlerFetch::read(void *ptr, size_t size, size_t n)
+{
+    Debug_println("FileHandlerFetch::read");
+    size_t len = size * n;
+    if (_position >= _size || len == 0)
+        return 0;
+    if (len > (size_t)(_size - _position))
+        len = _size - _position;
+
+    if (!has_copy())
+    {
+        std::lock_guard<std::mutex> fh_lock(_fh_mutex);
+        if (_fh->seek(_position, SEEK_SET) != 0)
+            return 0;
+        len = _fh->read(ptr, 1, len);
+    }
+    else
+    {
+        if (ensure(_position, len))
+            return 0;
+        std::lock_guard<std::mutex> lock(_mutex);
+        copy_read(_position, (uint8_t *)ptr, len);
+    }
+    _position += len;
+    return len / size;
+}
+
+
+size_t FileHandlerFetch::write(const void *ptr, size_t size, size_t n)
+{
+    Debug_println("FileHandlerFetch::write");
+    size_t len = size * n;
+    if (len == 0)
+        return 0;
+    // image doesn't grow
+    if (_position + (long int)len > _size)
+    {
+        errno = EFBIG;
+        return 0;
+    }
+
+    if (has_copy())
+    {
+        // blocks written only partially must hold file data first
+        long int first = _position / FETCH_BLOCK_SIZE;
+        long int last = (_position + len - 1) / FETCH_BLOCK_SIZE;
+        if (ensure(first * FETCH_BLOCK_SIZE, 1) || ensure(last * FETCH_BLOCK_SIZE, 1))
+            return 0;
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        copy_write(_position, (const uint8_t *)ptr, len);
+        for (long int b = first; b <= last; b++)
+        {
+            if (!_present[b])
+            {
+                _present[b] = 1;
+                _missing--;
+            }
+        }
+    }
+
+    if (_write_back || !has_copy())
+    {
+        std::lock_guard<std::mutex> fh_lock(_fh_mutex);
+        if (_fh->seek(_position, SEEK_SET) != 0 || _fh->write(ptr, 1, len) != len)
+        {
+            Debug_printf("FileHandlerFetch: write back failed: %d\n", errno);
+            return 0;
+        }
+    }
+    _position += len;
+    return n;
+}
+
+
+int FileHandlerFetch::flush()
+{
+    Debug_println("FileHandlerFetch::flush");
+    if (_write_back || !has_copy())
+    {
+        std::lock_guard<std::mutex> fh_lock(_fh_mutex);
+        return _fh->flush();
+    }
+    return 0;
+}
+
+
+// Call with _mutex held
+void FileHandlerFetch::copy_read(long int offset, uint8_t *data, size_t len)
+{
+    if (_buffer != nullptr)
+        memcpy(data, _buffer + offset, len);
+    else if (fseek(_spill, offset, SEEK_SET) != 0 || fread(data, 1, len, _spill) != len)
+        Debug_printf("FileHandlerFetch: spill read failed: %d\n", errno);
+}
+
+
+// Call with _mutex held
+void FileHandlerFetch::copy_write(long int offset, const uint8_t *data, size_t len)
+{
+    if (_buffer != nullptr)
+        memcpy(_buffer + offset, data, len);
+    else if (fseek(_spill, offset, SEEK_SET) != 0 || fwrite(data, 1, len, _spill) != len)
+        Debug_printf("FileHandlerFetch: spill write failed: %d\n", errno);
+}
+
+
+// Reads blocks from file, keeps those which got present meanwhile
+// Returns TRUE if an error condition occurred
+bool FileHandlerFetch::fetch_blocks(long int first, long int count)
+{
+    long int offset = first * FETCH_BLOCK_SIZE;
+    size_t len = count * FETCH_BLOCK_SIZE;
+    if (offset + (long int)len > _size)
+        len = _size - offset;
+
+    std::vector<uint8_t> data(len);
+    std::lock_guard<std::mutex> fh_lock(_fh_mutex);
+    if (_fh->seek(offset, SEEK_SET) != 0 || _fh->read(data.data(), 1, len) != len)
+    {
+        Debug_printf("FileHandlerFetch: read of %u bytes at %ld failed: %d\n", (unsigned)len, offset, errno);
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (long int b = first; b < first + count; b++)
+    {
+        if (_present[b])
+            continue;
+        long int boff = b * FETCH_BLOCK_SIZE;
+        size_t blen = boff + FETCH_BLOCK_SIZE > _size ? _size - boff : FETCH_BLOCK_SIZE;
+        copy_write(boff, &data[boff - offset], blen);
+        _present[b] = 1;
+        _missing--;
+    }
+    return false;
+}
+
+
+// Fetches missing blocks in offset .. offset + len now
+// Returns TRUE if an error condition occurred
+bool FileHandlerFetch::ensure(long int offset, size_t len)
+{
+    long int b = offset / FETCH_BLOCK_SIZE;
+    long int last = (offset + len - 1) / FETCH_BLOCK_SIZE;
+    while (b <= last)
+    {
+        long int run;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            while (b <= last && _present[b])
+                b++;
+            run = 0;
+            while (b + run <= last && !_present[b + run])
+                run++;
+        }
+        if (run == 0)
+            break;
+        if (fetch_blocks(b, run))
+            return true;
+        b += run;
+        _hint = b;
+    }
+    return false;
+}
+
+
+// Copies file from start to end, skipping blocks already present
+// Continues after the last on-demand read, reader is likely to go on from there
+void FileHandlerFetch::fetch_loop()
+{
+    auto start = std::chrono::steady_clock::now();
+    long int blocks = _present.size();
+    long int chunk = FETCH_CHUNK_SIZE / FETCH_BLOCK_SIZE;
+    long int b = 0;
+    int errors = 0;
+
+    while (!_stop)
+    {
+        long int hint = _hint.exchange(-1);
+        if (hint >= 0 && hint < blocks)
+            b = hint;
+
+        long int run = 0;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_missing == 0)
+                break;
+            // wrap around to blocks skipped by jumping to hint
+            while (_present[b])
+                b = (b + 1) % blocks;
+            while (b + run < blocks && run < chunk && !_present[b + run])
+                run++;
+        }
+        if (fetch_blocks(b, run))
+        {
+            // leave the rest to on-demand reads
+            if (++errors >= 3)
+                break;
+            continue;
+        }
+        b = (b + run) % blocks;
+    }
+
+    long int ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(_mutex);
+    Debug_printf("FileHandlerFetch: fetch %s after %ld ms, %ld blocks missing\n", _missing == 0 ? "done" : "stopped", ms, _missing);
+}
@@ -0,0 +1,77 @@
+#ifndef _FN_FILEFETCH_
+#define _FN_FILEFETCH_
+
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+#include "fnFile.h"
+#include "fnFS.h"
+
+#define FETCH_BLOCK_SIZE    512     // unit of presence tracking, one TNFS read
+#define FETCH_CHUNK_SIZE    4096    // background fetch step, on-demand reads wait at most this long
+#ifdef ESP_PLATFORM
+#define FETCH_MEM_MAXSIZE   1048576
+#else
+#define FETCH_MEM_MAXSIZE   67108864
+#endif
+
+
+/*
+FileHandlerFetch - whole file copied to RAM (or spill file) by background thread
+Reads of the part which did not arrive yet are fetched on demand. Writes go to the copy
+and optionally to the file too (write back), otherwise they are lost on close.
+If the copy can't be allocated, everything goes directly to the file.
+*/
+
+class FileHandlerFetch : public FileHandler
+{
+protected:
+    FileHandler *_fh = nullptr;     // fetched file, owned
+    long int _size;
+    bool _write_back;
+
+    // copy, either in buffer or in spill file
+    uint8_t *_buffer = nullptr;
+    FILE *_spill = nullptr;
+    FileSystem *_spill_fs = nullptr;
+    std::string _spill_path;
+
+    long int _position = 0;
+
+    std::mutex _mutex;              // copy and _present, lock after _fh_mutex
+    std::vector<uint8_t> _present;  // per block, copy holds file data or newer
+    long int _missing;              // blocks not present
+
+    std::mutex _fh_mutex;           // fetched file
+    std::atomic<bool> _stop{false};
+    std::atomic<long int> _hint{-1};    // block after last on-demand read, fetch continues there
+    std::thread _thread;
+
+    bool has_copy() { return _buffer != nullptr || _spill != nullptr; };
+    void copy_read(long int offset, uint8_t *data, size_t len);
+    void copy_write(long int offset, const uint8_t *data, size_t len);
+
+    // Returns TRUE if an error condition occurred
+    bool fetch_blocks(long int first, long int count);
+    bool ensure(long int offset, size_t len);
+    void fetch_loop();
+
+public:
+    // spill_fs and spill_path give file for copy, nullptr for RAM
+    FileHandlerFetch(FileHandler *fh, long int size, bool write_back, FileSystem *spill_fs = nullptr, const char *spill_path = nullptr);
+    virtual ~FileHandlerFetch() override;
+
+    virtual int close(bool destroy=true) override;
+    virtual int seek(long int off, int whence) override;
+    virtual long int tell() override;
+    virtual size_t read(void *ptr, size_t size, size_t n) override;
+    virtual size_t write(const void *ptr, size_t size, size_t n) override;
+    virtual int flush() override;
+};
+
+
+#endif //_FN_FILEFETCH_
@@ -1,4 +1,9 @@
 #include <unistd.h>  // for fsync
+#include <errno.h>
+#if !defined(ESP_PLATFORM) && !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #include "fnFileLocal.h"
 
 #include "../../include/debug.h"
@@ -22,6 +27,7 @@ int FileHandlerLocal::close(bool destroy)
 {
     Debug_println("FileHandlerLocal::close");
     int result = 0;
+    munmap_view();
     if (_fh != nullptr) 
     {
         result = fclose(_fh);
@@ -64,6 +70,57 @@ int FileHandlerLocal::flush()
 {
     Debug_println("FileHandlerLocal::flush");
     int ret = fflush(_fh);    // This doesn't seem to be connected to anything in ESP-IDF VF, so it may not do anything
+#if !defined(ESP_PLATFORM) && !defined(_WIN32)
+    if (_map != nullptr && _map_writable)
+        ret |= msync(_map, _map_size, MS_SYNC);
+#endif
     // ret = fsync(fileno(_fh)); // Since we might get reset at any moment, go ahead and sync the file (not clear if fflush does this)
     return ret;
 }
+
+
+uint8_t *FileHandlerLocal::mmap_view(size_t *size, bool writable)
+{
+#if defined(ESP_PLATFORM) || defined(_WIN32)
+    return nullptr;
+#else
+    if (_map != nullptr && writable && !_map_writable)
+        return nullptr;
+    if (_map == nullptr && _fh != nullptr)
+    {
+        fflush(_fh);
+        struct stat st;
+        if (fstat(fileno(_fh), &st) != 0 || st.st_size <= 0)
+            return nullptr;
+        // fails for file opened read-only
+        void *p = ::mmap(nullptr, st.st_size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fileno(_fh), 0);
+        if (p == MAP_FAILED)
+        {
+            Debug_printf("FileHandlerLocal::mmap_view failed: %d\n", errno);
+            return nullptr;
+        }
+        _map = (uint8_t *)p;
+        _map_size = st.st_size;
+        _map_writable = writable;
+    }
+    if (_map != nullptr && size != nullptr)
+        *size = _map_size;
+    return _map;
+#endif
+}
+
+
+void FileHandlerLocal::munmap_view()
+{
+#if !defined(ESP_PLATFORM) && !defined(_WIN32)
+    if (_map != nullptr)
+    {
+        if (_map_writable)
+            msync(_map, _map_size, MS_SYNC);
+        ::munmap(_map, _map_size);
+        _map = nullptr;
+        _map_size = 0;
+        _map_writable = false;
+    }
+#endif
+}
@@ -9,6 +9,9 @@ class FileHandlerLocal : public FileHandler
 {
 protected:
     FILE *_fh = nullptr;
+    uint8_t *_map = nullptr;
+    size_t _map_size = 0;
+    bool _map_writable = false;
 
 public:
     FileHandlerLocal(FILE *fh);
@@ -20,6 +23,9 @@ public:
     virtual size_t read(void *ptr, size_t size, size_t n) override;
     virtual size_t write(const void *ptr, size_t size, size_t n) override;
     virtual int flush() override;
+
+    virtual uint8_t *mmap_view(size_t *size, bool writable = false) override;
+    virtual void munmap_view() override;
 };
 
 
@@ -0,0 +1,497 @@
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#if defined(_WIN32)
+#include <io.h>
+#endif
+#include <chrono>
+#include <iterator>
+
+#include "fnFileWriteBehind.h"
+#include "utils.h"
+#include "../../include/debug.h"
+
+
+static uint64_t writebehind_ms()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int writebehind_fsync(FILE *f)
+{
+    if (fflush(f) != 0)
+        return -1;
+#if defined(_WIN32)
+    return _commit(_fileno(f));
+#else
+    return fsync(fileno(f));
+#endif
+}
+
+
+std::mutex FileHandlerWriteBehind::_journals_mutex;
+std::set<std::string> FileHandlerWriteBehind::_journals;
+
+
+FileHandlerWriteBehind::FileHandlerWriteBehind(FileHandler *fh, FileSystem *journal_fs, const char *journal_path)
+    : _fh(fh), _journal_fs(journal_fs), _journal_path(journal_path)
+{
+    Debug_printf("new FileHandlerWriteBehind, journal %s\n", journal_path);
+
+    {
+        // other layer would replay and remove our records
+        std::lock_guard<std::mutex> lock(_journals_mutex);
+        if (!_journals.insert(_journal_path).second)
+        {
+            Debug_printf("FileHandlerWriteBehind: journal %s in use, writing through\n", journal_path);
+            return;
+        }
+    }
+
+    _journal = _journal_fs->file_open(journal_path, "rb+");
+    if (_journal == nullptr)
+        _journal = _journal_fs->file_open(journal_path, "wb+");
+    if (_journal == nullptr)
+    {
+        // writes go directly to file
+        Debug_printf("FileHandlerWriteBehind: can't open journal %s, writing through\n", journal_path);
+        std::lock_guard<std::mutex> lock(_journals_mutex);
+        _journals.erase(_journal_path);
+        return;
+    }
+
+    journal_replay();
+    _thread = std::thread(&FileHandlerWriteBehind::write_out_loop, this);
+}
+
+
+FileHandlerWriteBehind::~FileHandlerWriteBehind()
+{
+    Debug_println("delete FileHandlerWriteBehind");
+    if (_fh != nullptr) close(false);
+}
+
+
+int FileHandlerWriteBehind::close(bool destroy)
+{
+    Debug_println("FileHandlerWriteBehind::close");
+    int result = 0;
+
+    if (_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _cv.notify_one();
+        _thread.join();
+    }
+
+    if (_journal != nullptr)
+    {
+        bool pending = true;
+        while (pending)
+        {
+            if (write_out())
+            {
+                result = -1;
+                break;
+            }
+            std::lock_guard<std::mutex> lock(_mutex);
+            pending = !_dirty.empty();
+        }
+        fclose(_journal);
+        _journal = nullptr;
+        // keep journal for replay if file can't be written now
+        if (result == 0)
+            _journal_fs->remove(_journal_path.c_str());
+        else
+            Debug_printf("FileHandlerWriteBehind: write out failed, keeping journal %s\n", _journal_path.c_str());
+        std::lock_guard<std::mutex> lock(_journals_mutex);
+        _journals.erase(_journal_path);
+    }
+
+    if (_fh != nullptr)
+    {
+        if (_fh->close() != 0)
+            result = -1;
+        _fh = nullptr;
+    }
+    if (destroy) delete this;
+    return result;
+}
+
+
+int FileHandlerWriteBehind::seek(long int off, int whence)
+{
+    Debug_println("FileHandlerWriteBehind::seek");
+    switch (whence)
+    {
+    case SEEK_SET:
+        break;
+    case SEEK_CUR:
+        off += _position;
+        break;
+    case SEEK_END:
+        {
+            std::lock_guard<std::mutex> lock(_fh_mutex);
+            _fh_position = -1;
+            if (_fh->seek(off, SEEK_END) != 0)
+                return -1;
+            off = _fh->tell();
+            _fh_position = off;
+        }
+        break;
+    default:
+        errno = EINVAL;
+        return -1;
+    }
+    if (off < 0)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    _position = off;
+    return 0;
+}
+
+
+long int FileHandlerWriteBehind::tell()
+{
+    Debug_println("FileHandlerWriteBehind::tell");
+    return _position;
+}
+
+
+size_t FileHandlerWriteBehind::read(void *ptr, size_t size, size_t n)
+{
+    Debug_println("FileHandlerWriteBehind::read");
+    size_t len = size * n;
+    if (len == 0)
+        return 0;
+
+    std::lock_guard<std::mutex> fh_lock(_fh_mutex);
+    if (_fh_position != _position)
+    {
+        _fh_position = -1;
+        if (_fh->seek(_position, SEEK_SET) != 0)
+            return 0;
+    }
+    size_t got = _fh->read(ptr, 1, len);
+    _fh_position = _position + got;
+
+    // pending writes are newer than file, data being written out is older than pending writes
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        overlay(_flushing, _position, (uint8_t *)ptr, got);
+        overlay(_dirty, _position, (uint8_t *)ptr, got);
+    }
+    _position += got;
+    return got / size;
+}
+
+
+size_t FileHandlerWriteBehind::write(const void *ptr, size_t size, size_t n)
+{
+    Debug_println("FileHandlerWriteBehind::write");
+    size_t len = size * n;
+    if (len == 0)
+        return 0;
+
+    if (_journal == nullptr)
+    {
+        std::lock_guard<std::mutex> fh_lock(_fh_mutex);
+        if (_fh_position != _position)
+        {
+            _fh_position = -1;
+            if (_fh->seek(_position, SEEK_SET) != 0)
+                return 0;
+        }
+        size_t written = _fh->write(ptr, 1, len);
+        _fh_position = _position + written;
+        _position += written;
+        return written / size;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (journal_append(_position, (const uint8_t *)ptr, len))
+            return 0;
+
+        uint64_t now = writebehind_ms();
+        if (_dirty.empty())
+            _first_write_ms = now;
+        _last_write_ms = now;
+        merge(_dirty, _position, (const uint8_t *)ptr, len);
+    }
+    _cv.notify_one();
+    _position += len;
+    return n;
+}
+
+
+int FileHandlerWriteBehind::flush()
+{
+    Debug_println("FileHandlerWriteBehind::flush");
+    if (_journal == nullptr)
+    {
+        std::lock_guard<std::mutex> fh_lock(_fh_mutex);
+        return _fh->flush();
+    }
+    return 0;
+}
+
+
+// Adds data to map, joins it with ranges it overlaps or touches
+void FileHandlerWriteBehind::merge(extent_map &map, uint32_t offset, const uint8_t *data, size_t len)
+{
+    uint32_t start = offset;
+    uint32_t end = offset + len;
+
+    auto first = map.upper_bound(offset);
+    if (first != map.begin())
+    {
+        auto prev = std::prev(first);
+        if (prev->first + prev->second.size() >= offset)
+            first = prev;
+    }
+    auto last = first;
+    while (last != map.end() && last->first <= end)
+    {
+        if (last->first < start)
+            start = last->first;
+        if (last->first + last->second.size() > end)
+            end = last->first + last->second.size();
+        ++last;
+    }
+
+    // sequential writes extend one range
+    if (first != last && std::next(first) == last && first->first == start)
+    {
+        std::vector<uint8_t> &v = first->second;
+        if (v.size() < end - start)
+            v.resize(end - start);
+        memcpy(&v[offset - start], data, len);
+        return;
+    }
+
+    std::vector<uint8_t> joined(end - start);
+    for (auto it = first; it != last; ++it)
+        memcpy(&joined[it->first - start], it->second.data(), it->second.size());
+    memcpy(&joined[offset - start], data, len);
+    map.erase(first, last);
+    map.emplace(start, std::move(joined));
+}
+
+
+// Copies parts of map which fall into offset .. offset + len to data
+void FileHandlerWriteBehind::overlay(const extent_map &map, uint32_t offset, uint8_t *data, size_t len)
+{
+    uint32_t end = offset + len;
+    auto it = map.upper_bound(offset);
+    if (it != map.begin())
+        --it;
+    for (; it != map.end() && it->first < end; ++it)
+    {
+        uint32_t from = it->first > offset ? it->first : offset;
+        uint32_t to = it->first + it->second.size();
+        if (to > end)
+            to = end;
+        if (from < to)
+            memcpy(data + (from - offset), it->second.data() + (from - it->first), to - from);
+    }
+}
+
+
+// Returns TRUE if an error condition occurred
+bool FileHandlerWriteBehind::journal_append(uint32_t offset, const uint8_t *data, size_t len)
+{
+    journal_record rec = { };
+    rec.magic = WRITEBEHIND_MAGIC;
+    rec.offset = offset;
+    rec.length = len;
+    rec.check = util_hash64(data, len, util_hash64(&rec.offset, sizeof(rec.offset) + sizeof(rec.length)));
+
+    if (fwrite(&rec, sizeof(rec), 1, _journal) != 1 || fwrite(data, 1, len, _journal) != len ||
+        writebehind_fsync(_journal) != 0)
+    {
+        Debug_printf("FileHandlerWriteBehind: journal write failed: %d\n", errno);
+        return true;
+    }
+    return false;
+}
+
+
+// Loads records up to the first incomplete one (write interrupted by crash) into map
+// Returns journal length up to there
+long FileHandlerWriteBehind::journal_scan(FILE *journal, extent_map &map, int *records)
+{
+    long valid = 0;
+    journal_record rec;
+    std::vector<uint8_t> data;
+
+    *records = 0;
+    fseek(journal, 0, SEEK_SET);
+    while (fread(&rec, sizeof(rec), 1, journal) == 1 && rec.magic == WRITEBEHIND_MAGIC)
+    {
+        data.resize(rec.length);
+        if (fread(data.data(), 1, rec.length, journal) != rec.length)
+            break;
+        if (rec.check != util_hash64(data.data(), rec.length, util_hash64(&rec.offset, sizeof(rec.offset) + sizeof(rec.length))))
+            break;
+        merge(map, rec.offset, data.data(), rec.length);
+        valid = ftell(journal);
+        (*records)++;
+    }
+    return valid;
+}
+
+
+void FileHandlerWriteBehind::journal_replay()
+{
+    int records;
+    long valid = journal_scan(_journal, _dirty, &records);
+
+    if (records > 0)
+        Debug_printf("FileHandlerWriteBehind: replaying %d journal records\n", records);
+
+    // new records go after last complete one
+    fflush(_journal);
+    if (ftruncate(fileno(_journal), valid) != 0)
+        Debug_printf("FileHandlerWriteBehind: journal truncate failed: %d\n", errno);
+    fseek(_journal, valid, SEEK_SET);
+    _first_write_ms = _last_write_ms = 0; // write out now
+}
+
+
+bool FileHandlerWriteBehind::journal_in_use(const char *journal_path)
+{
+    std::lock_guard<std::mutex> lock(_journals_mutex);
+    return _journals.count(journal_path) > 0;
+}
+
+
+// Returns TRUE if an error condition occurred
+bool FileHandlerWriteBehind::journal_apply(FileHandler *fh, FileSystem *journal_fs, const char *journal_path)
+{
+    FILE *journal = journal_fs->file_open(journal_path, "rb");
+    if (journal == nullptr)
+        return false;
+
+    extent_map map;
+    int records;
+    journal_scan(journal, map, &records);
+    fclose(journal);
+    Debug_printf("FileHandlerWriteBehind: applying %d records of journal %s\n", records, journal_path);
+
+    for (auto &e : map)
+    {
+        if (fh->seek(e.first, SEEK_SET) != 0 || fh->write(e.second.data(), 1, e.second.size()) != e.second.size())
+        {
+            Debug_printf("FileHandlerWriteBehind: applying journal failed: %d, keeping %s\n", errno, journal_path);
+            return true;
+        }
+    }
+    if (fh->flush() != 0)
+    {
+        Debug_printf("FileHandlerWriteBehind: applying journal failed: %d, keeping %s\n", errno, journal_path);
+        return true;
+    }
+    journal_fs->remove(journal_path);
+    return false;
+}
+
+
+// Everything in journal is in file, call with _mutex held
+void FileHandlerWriteBehind::journal_reset()
+{
+    fflush(_journal);
+    if (ftruncate(fileno(_journal), 0) != 0)
+        Debug_printf("FileHandlerWriteBehind: journal truncate failed: %d\n", errno);
+    fseek(_journal, 0, SEEK_SET);
+}
+
+
+// Writes pending ranges to file, one seek and write per range
+// Returns TRUE if an error condition occurred
+bool FileHandlerWriteBehind::write_out()
+{
+    std::lock_guard<std::mutex> flush_lock(_flush_mutex);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_dirty.empty())
+            return false;
+        _flushing.swap(_dirty);
+    }
+
+    bool err = false;
+    int runs = 0;
+    {
+        std::lock_guard<std::mutex> fh_lock(_fh_mutex);
+        for (auto &e : _flushing)
+        {
+            _fh_position = -1;
+            if (_fh->seek(e.first, SEEK_SET) != 0 || _fh->write(e.second.data(), 1, e.second.size()) != e.second.size())
+            {
+                err = true;
+                break;
+            }
+            _fh_position = e.first + e.second.size();
+            runs++;
+        }
+        if (!err && _fh->flush() != 0)
+            err = true;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (err)
+    {
+        // writes which came meanwhile are newer
+        Debug_printf("FileHandlerWriteBehind: write out failed: %d\n", errno);
+        extent_map newer;
+        newer.swap(_dirty);
+        _dirty.swap(_flushing);
+        for (auto &e : newer)
+            merge(_dirty, e.first, e.second.data(), e.second.size());
+        _write_error = true;
+        return true;
+    }
+    Debug_printf("FileHandlerWriteBehind: wrote %d runs\n", runs);
+    _flushing.clear();
+    _write_error = false;
+    if (_dirty.empty())
+        journal_reset();
+    return false;
+}
+
+
+void FileHandlerWriteBehind::write_out_loop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stop)
+    {
+        if (_dirty.empty())
+        {
+            _cv.wait(lock);
+            continue;
+        }
+        // let writes of one operation pile up, retry failed write out later
+        uint64_t now = writebehind_ms();
+        uint64_t due = _last_write_ms + WRITEBEHIND_IDLE_MS;
+        if (_first_write_ms + WRITEBEHIND_MAX_AGE_MS < due)
+            due = _first_write_ms + WRITEBEHIND_MAX_AGE_MS;
+        if (_write_error)
+            due = now + WRITEBEHIND_MAX_AGE_MS;
+        if (now < due)
+        {
+            _cv.wait_for(lock, std::chrono::milliseconds(due - now));
+            if (_write_error && !_stop)
+                _write_error = false;
+            continue;
+        }
+        lock.unlock();
+        write_out();
+        lock.lock();
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef _FN_FILEWRITEBEHIND_
+#define _FN_FILEWRITEBEHIND_
+
+#include <stdint.h>
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include "fnFile.h"
+#include "fnFS.h"
+
+#define WRITEBEHIND_IDLE_MS     100     // write out when no write came for this long
+#define WRITEBEHIND_MAX_AGE_MS  1000    // or when oldest pending write is this old, also retry delay
+#define WRITEBEHIND_MAGIC       0x4a425746 // "FWBJ"
+
+
+/*
+FileHandlerWriteBehind - write-behind layer for slow (remote) files
+Writes return as soon as they are durable in local journal. Background thread writes
+pending data to the file as contiguous runs. Journal left by crash is replayed when
+the file is opened again with the same journal, or applied by journal_apply().
+One journal is used by one layer at a time.
+*/
+
+class FileHandlerWriteBehind : public FileHandler
+{
+protected:
+    // journal record, followed by length bytes of data
+    struct journal_record
+    {
+        uint32_t magic;
+        uint32_t offset;
+        uint32_t length;
+        uint32_t reserved;
+        uint64_t check; // util_hash64 of offset, length and data
+    };
+
+    // file offset -> data, ranges neither overlap nor touch
+    typedef std::map<uint32_t, std::vector<uint8_t>> extent_map;
+
+    FileHandler *_fh = nullptr;     // wrapped file, owned
+    FileSystem *_journal_fs;
+    std::string _journal_path;
+    FILE *_journal = nullptr;
+
+    long int _position = 0;         // as seen by caller
+    long int _fh_position = -1;     // of wrapped file, -1 if unknown
+
+    std::mutex _mutex;              // everything below, lock after _fh_mutex
+    extent_map _dirty;              // not written to file yet
+    extent_map _flushing;           // being written to file
+    uint64_t _first_write_ms = 0;   // oldest write in _dirty
+    uint64_t _last_write_ms = 0;
+    bool _write_error = false;      // last write out failed, data stays in journal
+    bool _stop = false;
+    std::condition_variable _cv;
+    std::thread _thread;
+
+    std::mutex _fh_mutex;           // wrapped file and _fh_position
+    std::mutex _flush_mutex;        // one write out at a time
+
+    static std::mutex _journals_mutex;
+    static std::set<std::string> _journals; // journals of open layers
+
+    static void merge(extent_map &map, uint32_t offset, const uint8_t *data, size_t len);
+    static void overlay(const extent_map &map, uint32_t offset, uint8_t *data, size_t len);
+    static long journal_scan(FILE *journal, extent_map &map, int *records);
+
+    bool journal_append(uint32_t offset, const uint8_t *data, size_t len);
+    void journal_replay();
+    void journal_reset();
+
+    // Returns TRUE if an error condition occurred
+    bool write_out();
+    void write_out_loop();
+
+public:
+    FileHandlerWriteBehind(FileHandler *fh, FileSystem *journal_fs, const char *journal_path);
+    virtual ~FileHandlerWriteBehind() override;
+
+    // writes out everything, journal is removed if that succeeded
+    virtual int close(bool destroy=true) override;
+    virtual int seek(long int off, int whence) override;
+    virtual long int tell() override;
+    virtual size_t read(void *ptr, size_t size, size_t n) override;
+    virtual size_t write(const void *ptr, size_t size, size_t n) override;
+    // written data is already durable in journal
+    virtual int flush() override;
+
+    // TRUE if an open layer uses journal, i.e. file is open for writing elsewhere
+    static bool journal_in_use(const char *journal_path);
+    // Writes records of journal left by crash to fh (open for writing) and removes journal
+    // Returns TRUE if an error condition occurred, journal is kept then
+    static bool journal_apply(FileHandler *fh, FileSystem *journal_fs, const char *journal_path);
+};
+
+
+#endif //_FN_FILEWRITEBEHIND_
@@ -1226,7 +1226,9 @@ const char *tnfs_getcwd(tnfsMountInfo *m_info)
  */
 bool _tnfs_transaction(tnfsMountInfo *m_info, tnfsPacket &pkt, uint16_t payload_size)
 {
-    fnUDP udp;
+    // Socket is kept with mount info, replies must not go to another thread's transaction
+    std::lock_guard<std::recursive_mutex> lock(m_info->transaction_mutex);
+    fnUDP &udp = m_info->udp;
 
     // Keep copy of 1st payload byte
     uint8_t payload_0 = pkt.payload[0];
@@ -1277,23 +1279,33 @@ bool _tnfs_transaction(tnfsMountInfo *m_info, tnfsPacket &pkt, uint16_t payload_
                     return true; // false success just to get out
                 }
 
-                fnSystem.delay_microseconds(2000); // wait short time for (local) data to arrive
-                if (udp.parsePacket())
+                // Block until reply arrives, wake up now and then to check for shutdown
+                int wait_ms = m_info->timeout_ms - (int)(fnSystem.millis() - ms_start);
+                if (wait_ms > TNFS_SHUTDOWN_CHECK_MS)
+                    wait_ms = TNFS_SHUTDOWN_CHECK_MS;
+                if (wait_ms > 0 && udp.waitForPacket(wait_ms) && udp.parsePacket())
                 {
-                    unsigned short l = udp.read(pkt.rawData, sizeof(pkt.rawData));
-                    __IGNORE_UNUSED_VAR(l);
-#ifdef DEBUG
-                    _tnfs_debug_packet(pkt, l, true);
-#endif
+                    // Check header first, late reply to an earlier transaction must not overwrite our request
+                    uint8_t header[TNFS_HEADER_SIZE] = { 0 };
+                    int hl = udp.read(header, sizeof(header));
 
                     // Out of order packet received.
-                    if (pkt.sequence_num != current_sequence_num)
+                    if (hl != TNFS_HEADER_SIZE || header[2] != current_sequence_num)
                     {
-                        Debug_printf("TNFS OUT OF ORDER SEQUENCE! Rcvd: %x, Expected: %x\r\n", pkt.sequence_num, current_sequence_num);
+                        udp.flush();
+                        Debug_printf("TNFS OUT OF ORDER SEQUENCE! Rcvd: %x, Expected: %x\r\n", header[2], current_sequence_num);
                         // Fall through and let retry logic handle it.
                     }
                     else
                     {
+                        memcpy(pkt.rawData, header, TNFS_HEADER_SIZE);
+                        unsigned short l = TNFS_HEADER_SIZE + udp.read(pkt.rawData + TNFS_HEADER_SIZE, sizeof(pkt.rawData) - TNFS_HEADER_SIZE);
+                        udp.flush();
+                        __IGNORE_UNUSED_VAR(l);
+#ifdef DEBUG
+                        _tnfs_debug_packet(pkt, l, true);
+#endif
+
                         // Check in case the server asks us to wait and try again
                         if (pkt.payload[0] == TNFS_RESULT_TRY_AGAIN)
                         {
@@ -1333,8 +1345,6 @@ bool _tnfs_transaction(tnfsMountInfo *m_info, tnfsPacket &pkt, uint16_t payload_
                         }
                     }
                 }
-                fnSystem.delay_microseconds(5000); // wait more time for (remote) data to arrive
-
             } while ((fnSystem.millis() - ms_start) < m_info->timeout_ms);
 
             if (retry != -1)
@@ -3,8 +3,10 @@
 
 // #include <lwip/netdb.h>
 #include <cstdint>
+#include <mutex>
 
 #include "fnDNS.h"
+#include "fnUDP.h"
 
 
 #define TNFS_DEFAULT_PORT 16384
@@ -12,6 +14,7 @@
 #define TNFS_TIMEOUT 2000 // This is how long we wait for a reply packet from the server before trying again
 #define TNFS_RETRY_DELAY 1000 // Default delay before retrying. Server will provide a minimum during TNFS_CMD_MOUNT
 #define TNFS_MAX_BACKOFF_DELAY 3000 // Longest we'll wait if server sends us a EAGAIN error
+#define TNFS_SHUTDOWN_CHECK_MS 100 // Longest single wait for reply packet, shutdown is checked in between
 #define TNFS_MAX_FILE_HANDLES 8 // Max number of file handles we'll open to the server
 #define TNFS_MAX_FILELEN 256
 
@@ -98,6 +101,9 @@ public:
 
     int16_t dir_handle = TNFS_INVALID_HANDLE; // Stored from server's response to TNFS_OPENDIR
     uint16_t dir_entries = 0; // Stored from server's response to TNFS_OPENDIRX
+
+    fnUDP udp; // Socket used for every transaction with the server, opened by the first one
+    std::recursive_mutex transaction_mutex; // One transaction at a time on the socket (session recovery nests)
 };
 
 #endif // _TNFSLIB_MOUNTINFO_H
@@ -1,20 +1,52 @@
 #include "Connection.h"
 #include <iostream>
 
-std::vector<uint8_t> Connection::wait_for_request()
+bool Connection::wait_for_request(std::vector<uint8_t>& request)
 {
     // Use a timeout so we can stop waiting for responses
     while (is_connected_) {
         std::unique_lock<std::mutex> lock(responses_mutex_);
-        if (response_cv_.wait_for(lock, std::chrono::seconds(5), [this]() { return !responses_.empty(); })) {
-            const auto it = responses_.begin();
-            std::vector<uint8_t> request_data = it->second;
-            responses_.erase(it);
+        if (response_cv_.wait_for(lock, std::chrono::seconds(5), [this]() { return requests_count_ > 0 || !is_connected_; })) {
+            if (requests_count_ == 0) {
+                break;
+            }
+            request.swap(requests_[requests_head_]);
+            requests_head_ = (requests_head_ + 1) % CONNECTION_MAX_PENDING;
+            requests_count_--;
 
-            return request_data;
+            return true;
         }
     }
-    return std::vector<uint8_t>();
+    return false;
+}
+
+void Connection::add_request(const uint8_t* data, const size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(responses_mutex_);
+        size_t i;
+        for (i = 0; i < requests_count_; i++) {
+            auto& pending = requests_[(requests_head_ + i) % CONNECTION_MAX_PENDING];
+            if (pending[0] == data[0]) {
+                break;
+            }
+        }
+        if (i == requests_count_) {
+            // every sequence number has at most one slot, so there is always room
+            requests_count_++;
+        }
+        requests_[(requests_head_ + i) % CONNECTION_MAX_PENDING].assign(data, data + size);
+    }
+    response_cv_.notify_all();
+}
+
+void Connection::disconnect()
+{
+    {
+        std::lock_guard<std::mutex> lock(responses_mutex_);
+        set_is_connected(false);
+    }
+    response_cv_.notify_all();
 }
 
 void Connection::join()
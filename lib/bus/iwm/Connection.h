@@ -1,14 +1,16 @@
 #pragma once
 
 #include <vector>
+#include <array>
 #include <atomic>
-#include <map>
 #include <cstdint>
 #include <mutex>
 #include <condition_variable>
 #include <chrono>
 #include <thread>
 
+#define CONNECTION_MAX_PENDING 256 // one per request sequence number
+
 class Connection
 {
 public:
@@ -17,10 +19,15 @@ public:
 
 	virtual void create_read_channel() = 0;
 
+	// Marks the connection closed and wakes up reading thread and wait_for_request
+	virtual void disconnect();
+
 	bool is_connected() const { return is_connected_; }
 	void set_is_connected(const bool is_connected) { is_connected_ = is_connected; }
 
-	std::vector<uint8_t> wait_for_request();
+	// Waits for next received request and swaps it into request, so buffers keep their capacity.
+	// Returns false if the connection was closed.
+	bool wait_for_request(std::vector<uint8_t>& request);
 
 	void join();
 
@@ -28,7 +35,14 @@ private:
 	std::atomic<bool> is_connected_{false};
 
 protected:
-	std::map<uint8_t, std::vector<uint8_t>> responses_;
+	// Called by the reading thread for every received packet. A pending packet with
+	// the same request sequence number is replaced.
+	void add_request(const uint8_t* data, size_t size);
+
+	// received packets in arrival order, buffers are allocated once and reused
+	std::array<std::vector<uint8_t>, CONNECTION_MAX_PENDING> requests_;
+	size_t requests_head_ = 0;
+	size_t requests_count_ = 0;
 	std::thread reading_thread_;
 
 	std::mutex request_mutex_;
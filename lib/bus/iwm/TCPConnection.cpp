@@ -12,12 +12,34 @@
 #else
  #include <sys/socket.h>
  #include <netinet/in.h>
+ #include <netinet/tcp.h>
  #include <arpa/inet.h>
  #include <unistd.h>
 #endif
 
 #include "../../slip/SLIP.h"
 
+TCPConnection::~TCPConnection()
+{
+#ifdef _WIN32
+	closesocket(socket_);
+	WSACleanup();
+#else
+	close(socket_);
+#endif
+}
+
+void TCPConnection::disconnect()
+{
+	Connection::disconnect();
+	// unblock recv in reading thread
+#ifdef _WIN32
+	shutdown(socket_, SD_BOTH);
+#else
+	shutdown(socket_, SHUT_RDWR);
+#endif
+}
+
 void TCPConnection::send_data(const std::vector<uint8_t>& data)
 {
 	if (data.empty())
@@ -25,17 +47,26 @@ void TCPConnection::send_data(const std::vector<uint8_t>& data)
 		throw std::runtime_error("TCPConnection::send_data No data was supplied to send_data to send.");
 	}
 
-	const auto slip_data = SLIP::encode(data);
-	int sent_size = send(socket_, reinterpret_cast<const char*>(slip_data.data()), slip_data.size(), 0);
-
-	if (sent_size == -1) {
-		std::ostringstream msg;
-    msg << "TCPConnection::send_data Failed to send data: " << strerror(errno);
-    throw std::runtime_error(msg.str());
-	} else if (sent_size != slip_data.size()) {
-		std::ostringstream msg;
-    msg << "TCPConnection::send_data Only " << sent_size << " out of " << slip_data.size() << " bytes were sent";
-    throw std::runtime_error(msg.str());
+	std::lock_guard<std::mutex> lock(send_mutex_);
+	const size_t slip_size = SLIP::encode(data.data(), data.size(), send_buffer_);
+	size_t sent_total = 0;
+	while (sent_total < slip_size)
+	{
+		int sent_size = send(socket_, reinterpret_cast<const char*>(send_buffer_.data() + sent_total), slip_size - sent_total, 0);
+		if (sent_size == -1 && errno == EINTR)
+		{
+			continue;
+		}
+		if (sent_size <= 0)
+		{
+			// send timed out or failed, a partial frame would corrupt the SLIP stream
+			const int errsv = errno;
+			disconnect();
+			std::ostringstream msg;
+			msg << "TCPConnection::send_data Failed to send data after " << sent_total << " out of " << slip_size << " bytes: " << strerror(errsv);
+			throw std::runtime_error(msg.str());
+		}
+		sent_total += sent_size;
 	}
 }
 
@@ -44,70 +75,52 @@ void TCPConnection::create_read_channel()
 	// Start a new thread to listen for incoming data
 	reading_thread_ = std::thread([self = shared_from_this()]()
 	{
-		std::vector<uint8_t> complete_data;
-		std::vector<uint8_t> buffer(1024);
+		// partial frames are kept in decoder until next recv
+		SLIPDecoder decoder;
+		std::vector<uint8_t> buffer(TCP_READ_BUFFER_SIZE);
 		bool is_initialising = true;
 
-		// Set a timeout on the socket
+		// Requests and responses are small, send them right away (no Nagle)
+		int nodelay = 1;
+		setsockopt(self->get_socket(), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<char*>(&nodelay), sizeof(nodelay));
+		// recv blocks until data arrives or disconnect() shuts the socket down
 		struct timeval timeout;
-		timeout.tv_sec = 1;
+		timeout.tv_sec = TCP_SEND_TIMEOUT_SEC;
 		timeout.tv_usec = 0;
-		setsockopt(self->get_socket(), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<char*>(&timeout), sizeof(timeout));
+		setsockopt(self->get_socket(), SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<char*>(&timeout), sizeof(timeout));
 
 		while (self->is_connected() || is_initialising)
 		{
-			int valread = 0;
-			do
+			if (is_initialising)
 			{
-				if (is_initialising)
-				{
-					is_initialising = false;
-					self->set_is_connected(true);
-				}
+				is_initialising = false;
+				self->set_is_connected(true);
+			}
 
-				valread = recv(self->get_socket(), reinterpret_cast<char*>(buffer.data()), buffer.size(), 0);
-				const int errsv = errno;
-				if (valread < 0)
-				{
-					// timeout is fine, just reloop.
-					if (errno == EAGAIN || errno == EWOULDBLOCK || errsv == 0)
-					{
-						continue;
-					}
-					// otherwise it was a genuine error.
-					std::cerr << "Error in read thread for connection, errno: " << errsv << " = " << strerror(errsv) << std::endl;
-					self->set_is_connected(false);
-				}
-				if (valread == 0)
-				{
-					// disconnected, close connection, should remove it too: TODO
-					self->set_is_connected(false);
-				}
-				if (valread > 0)
+			int valread = recv(self->get_socket(), reinterpret_cast<char*>(buffer.data()), buffer.size(), 0);
+			const int errsv = errno;
+			if (valread < 0)
+			{
+				// interrupted, just reloop.
+				if (errsv == EINTR || errsv == 0)
 				{
-					complete_data.insert(complete_data.end(), buffer.begin(), buffer.begin() + valread);
+					continue;
 				}
+				// otherwise it was a genuine error.
+				std::cerr << "Error in read thread for connection, errno: " << errsv << " = " << strerror(errsv) << std::endl;
+				self->disconnect();
 			}
-			while (valread == 1024);
-
-			if (!complete_data.empty())
+			if (valread == 0)
 			{
-				std::vector<std::vector<uint8_t>> decoded_packets = SLIP::split_into_packets(complete_data.data(), complete_data.size());
-				if (!decoded_packets.empty())
+				// disconnected, wake up whoever waits for requests
+				self->disconnect();
+			}
+			if (valread > 0)
+			{
+				decoder.feed(buffer.data(), valread, [&self](const uint8_t* packet, size_t size)
 				{
-					for (const auto& packet : decoded_packets)
-					{
-						if (!packet.empty())
-						{
-							{
-								std::lock_guard<std::mutex> lock(self->responses_mutex_);
-								self->responses_[packet[0]] = packet;
-							}
-							self->response_cv_.notify_all();
-						}
-					}
-				}
-				complete_data.clear();
+					self->add_request(packet, size);
+				});
 			}
 		}
 	});
@@ -3,18 +3,29 @@
 #include "Connection.h"
 #include <string>
 #include <memory>
+#include <mutex>
+
+#define TCP_READ_BUFFER_SIZE 4096
+#define TCP_SEND_TIMEOUT_SEC 1 // a stalled peer must not block the bus for long
 
 class TCPConnection : public Connection, public std::enable_shared_from_this<TCPConnection>
 {
 public:
 	TCPConnection(int socket) : socket_(socket) {}
+	// closes the socket
+	~TCPConnection() override;
 
 	virtual void send_data(const std::vector<uint8_t>& data) override;
 	virtual void create_read_channel() override;
+	virtual void disconnect() override;
 
 	int get_socket() const { return socket_; }
 	void set_socket(int socket) { this->socket_ = socket; }
 
 private:
 	int socket_;
+
+	// reused for every send, SLIP encoded data
+	std::vector<uint8_t> send_buffer_;
+	std::mutex send_mutex_;
 };
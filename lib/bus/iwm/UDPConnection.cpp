@@ -0,0 +1,153 @@
+#include "UDPConnection.h"
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+ #include <winsock2.h>
+ #include <ws2tcpip.h>
+#else
+ #include <sys/socket.h>
+ #include <netinet/in.h>
+ #include <arpa/inet.h>
+ #include <unistd.h>
+#endif
+
+UDPConnection::~UDPConnection()
+{
+#ifdef _WIN32
+	closesocket(socket_);
+	WSACleanup();
+#else
+	close(socket_);
+#endif
+}
+
+void UDPConnection::disconnect()
+{
+	Connection::disconnect();
+	// unblock recv in reading thread
+#ifdef _WIN32
+	shutdown(socket_, SD_BOTH);
+#else
+	shutdown(socket_, SHUT_RDWR);
+#endif
+}
+
+void UDPConnection::send_datagram(const uint8_t* data, const size_t size)
+{
+	std::lock_guard<std::mutex> lock(send_mutex_);
+	int sent_size = send(socket_, reinterpret_cast<const char*>(data), size, 0);
+	if (sent_size == -1) {
+		std::ostringstream msg;
+		msg << "UDPConnection::send_data Failed to send data: " << strerror(errno);
+		throw std::runtime_error(msg.str());
+	}
+}
+
+void UDPConnection::send_data(const std::vector<uint8_t>& data)
+{
+	if (data.empty())
+	{
+		throw std::runtime_error("UDPConnection::send_data No data was supplied to send_data to send.");
+	}
+
+	{
+		// keep the response in case the request is retransmitted
+		std::lock_guard<std::mutex> lock(slots_mutex_);
+		sequence_slot& slot = slots_[data[0]];
+		if (slot.used)
+		{
+			slot.response.assign(data.begin(), data.end());
+		}
+	}
+	send_datagram(data.data(), data.size());
+}
+
+bool UDPConnection::is_duplicate(const uint8_t* data, const size_t size)
+{
+	std::lock_guard<std::mutex> lock(slots_mutex_);
+	sequence_slot& slot = slots_[data[0]];
+	const auto now = std::chrono::steady_clock::now();
+	if (slot.used && latest_sequence_ == data[0] && now - slot.time < std::chrono::milliseconds(UDP_DUPLICATE_WINDOW_MS) &&
+		slot.request.size() == size && std::equal(slot.request.begin(), slot.request.end(), data))
+	{
+		// still being processed, the response will be sent when ready
+		if (!slot.response.empty())
+		{
+			try {
+				send_datagram(slot.response.data(), slot.response.size());
+			} catch (const std::runtime_error& e) {
+				std::cerr << e.what() << std::endl;
+			}
+		}
+		return true;
+	}
+
+	slot.request.assign(data, data + size);
+	slot.response.clear();
+	slot.time = now;
+	slot.used = true;
+	latest_sequence_ = data[0];
+	return false;
+}
+
+void UDPConnection::create_read_channel()
+{
+	// Start a new thread to listen for incoming datagrams
+	reading_thread_ = std::thread([self = shared_from_this()]()
+	{
+		std::vector<uint8_t> buffer(UDP_MAX_DATAGRAM_SIZE);
+		bool peer_heard = false;
+		const uint8_t announce = 0;
+
+		// wake up regularly to announce ourselves until the peer is heard
+		struct timeval timeout;
+		timeout.tv_sec = UDP_ANNOUNCE_SEC;
+		timeout.tv_usec = 0;
+		setsockopt(self->get_socket(), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<char*>(&timeout), sizeof(timeout));
+		send(self->get_socket(), reinterpret_cast<const char*>(&announce), 0, 0);
+
+		while (self->is_connected())
+		{
+			int valread = recv(self->get_socket(), reinterpret_cast<char*>(buffer.data()), buffer.size(), 0);
+			const int errsv = errno;
+			if (valread < 0)
+			{
+				// timeout, or peer not listening yet (ICMP port unreachable)
+				if (errsv == EAGAIN || errsv == EWOULDBLOCK || errsv == ECONNREFUSED || errsv == EINTR)
+				{
+					if (!peer_heard)
+					{
+						send(self->get_socket(), reinterpret_cast<const char*>(&announce), 0, 0);
+					}
+					continue;
+				}
+				std::cerr << "Error in read thread for UDP connection, errno: " << errsv << " = " << strerror(errsv) << std::endl;
+				self->disconnect();
+				break;
+			}
+			// empty datagram from peer, or socket was shut down
+			if (valread == 0)
+			{
+				continue;
+			}
+
+			if (!peer_heard)
+			{
+				// peer knows our address, no need to wake up any more
+				peer_heard = true;
+				timeout.tv_sec = 0;
+				setsockopt(self->get_socket(), SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<char*>(&timeout), sizeof(timeout));
+			}
+			if (!self->is_duplicate(buffer.data(), valread))
+			{
+				self->add_request(buffer.data(), valread);
+			}
+		}
+	});
+}
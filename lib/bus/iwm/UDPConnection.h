@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Connection.h"
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#define UDP_MAX_DATAGRAM_SIZE   65536
+#define UDP_DUPLICATE_WINDOW_MS 2000 // same request again within this time is a retransmit
+#define UDP_ANNOUNCE_SEC        1    // until peer is heard from, tell it our address this often
+
+// SmartPort over UDP, one packet per datagram (no SLIP framing).
+// The peer retransmits a request when its response doesn't arrive in time.
+// A retransmitted request (same request_sequence_number and data as the
+// latest request) is not executed again, the response already sent for it
+// is sent again instead. Older sequence numbers are never duplicates, the
+// 8-bit number wraps and a new identical request may reuse one of them.
+// As the peer can't know our address before we send something, an empty
+// datagram is sent to it until the first request arrives.
+class UDPConnection : public Connection, public std::enable_shared_from_this<UDPConnection>
+{
+public:
+	UDPConnection(int socket) : socket_(socket) {}
+	// closes the socket
+	~UDPConnection() override;
+
+	virtual void send_data(const std::vector<uint8_t>& data) override;
+	virtual void create_read_channel() override;
+	virtual void disconnect() override;
+
+	int get_socket() const { return socket_; }
+
+private:
+	// true if packet is a retransmitted request, its response is sent again if ready
+	bool is_duplicate(const uint8_t* data, size_t size);
+	void send_datagram(const uint8_t* data, size_t size);
+
+	// last request and response per sequence number, buffers are reused
+	struct sequence_slot
+	{
+		std::vector<uint8_t> request;
+		std::vector<uint8_t> response; // empty while request is being processed
+		std::chrono::steady_clock::time_point time;
+		bool used = false;
+	};
+
+	int socket_;
+	std::array<sequence_slot, 256> slots_;
+	int latest_sequence_ = -1; // of last executed request, only it can be retransmitted
+	std::mutex slots_mutex_;
+	std::mutex send_mutex_;
+};
@@ -147,8 +147,8 @@ void print_packet_wave(uint8_t *data, int bytes)
 // uint16_t iwmDevice::packet_len = 0;
 // uint16_t iwmDevice::num_decoded = 0;
 
-uint8_t iwmDevice::data_buffer[MAX_DATA_LEN] = {0};
-int iwmDevice::data_len = 0;
+thread_local uint8_t iwmDevice::data_buffer[MAX_DATA_LEN] = {0};
+thread_local int iwmDevice::data_len = 0;
 
 void iwmBus::iwm_ack_deassert()
 {
@@ -491,6 +491,16 @@ void iwmDevice::iwm_status(iwm_decoded_cmd_t cmd) // override;
 //*****************************************************************************
 void IRAM_ATTR iwmBus::service()
 {
+#if SMARTPORT == SLIP
+  // writes to mapped images are held back, bus runs at least every EVENT_LOOP_MAX_IDLE_MS
+  // disks are mounted and unmounted by this thread only
+  for (auto devicep : _daisyChain)
+  {
+    if (devicep->internal_type == iwm_fujinet_type_t::BlockDisk)
+      ((iwmDisk *)devicep)->sync();
+  }
+#endif
+
   // process smartport before diskII
   // read phase lines to check for smartport reset or enable
   switch (iwm_phases())
@@ -550,6 +560,10 @@ void IRAM_ATTR iwmBus::service()
 #ifdef DEBUG
       print_packet(command_packet.data);
       Debug_printf("\nhandling init command");
+#endif
+#if SMARTPORT == SLIP
+      // unit numbers are reassigned, finish requests for old ones
+      smartport.wait_for_units();
 #endif
       handle_init();
     }
@@ -574,6 +588,16 @@ void IRAM_ATTR iwmBus::service()
           print_packet(command_packet.data);
 
           _activeDev = devicep;
+#if SMARTPORT == SLIP
+          // other units keep going while this one waits, e.g. network unit on a slow host
+          if (devicep != _fujiDev)
+          {
+            smartport.dispatch(devicep, devicep->internal_type == iwm_fujinet_type_t::BlockDisk);
+            break;
+          }
+          // fuji device mounts and ejects disks of other units, let them finish first
+          smartport.wait_for_units();
+#endif
           // handle command
           memset(command.decoded, 0, sizeof(command.decoded));
           smartport.decode_data_packet(command_packet.data, command.decoded);
@@ -780,6 +804,7 @@ void iwmBus::addDevice(iwmDevice *pDevice, iwm_fujinet_type_t deviceType)
     break;
   }
 
+  pDevice->internal_type = deviceType;
   pDevice->_devnum = 0;
   pDevice->_initialized = false;
 
@@ -174,6 +174,9 @@ struct iwm_device_info_block_t
 class iwmDevice
 {
 friend iwmBus; // put here for prototype, not sure if will need to keep it
+#if SMARTPORT == SLIP
+friend iwm_slip; // processes requests on unit workers
+#endif
 
 protected:
   // set these things in constructor or initializer?
@@ -218,9 +221,9 @@ protected:
   void iwm_return_ioerror();
   void iwm_return_noerror();
 
-  // iwm packet handling
-  static uint8_t data_buffer[MAX_DATA_LEN]; // un-encoded binary data (512 bytes for a block)
-  static int data_len; // how many bytes in the data buffer
+  // iwm packet handling, one per thread as SmartPort units are processed concurrently
+  static thread_local uint8_t data_buffer[MAX_DATA_LEN]; // un-encoded binary data (512 bytes for a block)
+  static thread_local int data_len; // how many bytes in the data buffer
 
 public:
   bool device_active;
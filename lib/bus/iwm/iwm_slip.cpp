@@ -28,9 +28,12 @@
 #include "iwm_slip.h"
 #include "iwm.h"
 #include "TCPConnection.h"
-#include "../slip/Request.h"
+#include "UDPConnection.h"
 #include "fnConfig.h"
 #include "fnDNS.h"
+#include "fnEventLoop.h"
+#include "fnSystem.h"
+#include "../../include/debug.h"
 
 #define PHASE_IDLE   0b0000
 #define PHASE_ENABLE 0b1010
@@ -38,13 +41,32 @@
 
 sp_cmd_state_t sp_command_mode;
 
+thread_local slip_context_t *iwm_slip::worker_context_ = nullptr;
+
 iwm_slip::~iwm_slip() {
-  // stop listening for requests, and stop the connection.
+  // stop listening for requests, and stop the connections.
   is_responding_ = false;
-  connection_->set_is_connected(false);
-  connection_->join();
-  if (request_thread_.joinable()) {
-    request_thread_.join();
+  {
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    for (auto &client : clients_) {
+      if (client->connection != nullptr) {
+        client->connection->disconnect();
+      }
+    }
+  }
+  for (auto &client : clients_) {
+    if (client->thread.joinable()) {
+      client->thread.join();
+    }
+  }
+  for (auto &worker : units_) {
+    if (worker != nullptr) {
+      {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+      }
+      worker->cv.notify_one();
+      worker->thread.join();
+    }
   }
 }
 
@@ -53,22 +75,83 @@ void iwm_slip::setup_gpio()
 }
 
 void iwm_slip::setup_spi() {
-  // Create a listener for requests.
-  std::cout << "iwm_slip::setup_spi - attempting to connect to SLIP server " << Config.get_boip_host() << ":" << Config.get_boip_port() << std::endl;
-  bool connected = false;
-  // There really isn't anything else for this SLIP version to do than try and get a connection to server, so keep trying. User can kill process themselves.
-  while (!connected) {
+  // BOIP host is a comma separated list of host[:port], one client per entry
+  for (auto &entry : util_tokenize(Config.get_boip_host(), ',')) {
+    util_string_trim(entry);
+    if (entry.empty()) {
+      continue;
+    }
+    auto client = std::make_unique<slip_client_t>();
+    client->host = entry;
+    client->port = Config.get_boip_port();
+    size_t colon = entry.rfind(':');
+    if (colon != std::string::npos) {
+      client->host = entry.substr(0, colon);
+      client->port = atoi(entry.c_str() + colon + 1);
+    }
+    clients_.push_back(std::move(client));
+  }
+  if (clients_.empty()) {
+    std::cerr << "iwm_slip::setup_spi - no BOIP host configured" << std::endl;
+    return;
+  }
+
+  is_responding_ = true;
+  for (auto &client : clients_) {
+    client->thread = std::thread(&iwm_slip::client_loop, this, client.get());
+  }
+
+  // There really isn't anything else for this SLIP version to do than wait for a connection to server. User can kill process themselves.
+  while (connected_clients_ == 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+}
+
+void iwm_slip::client_loop(slip_client_t *client)
+{
+  // every client is served at the same time, requests of all connections go to the one device chain
+  while (is_responding_) {
+    std::cout << "iwm_slip::client_loop - attempting to connect to SLIP server " << client->host << ":" << client->port << std::endl;
+    std::shared_ptr<Connection> connection;
     try {
-      connected = connect_to_server(Config.get_boip_host(), Config.get_boip_port());
+      connection = connect_to_server(client->host, client->port);
     } catch (const std::runtime_error& e) {
-
+      std::cerr << "iwm_slip::client_loop - " << e.what() << std::endl;
     }
-    if (!connected) {
+    if (connection == nullptr) {
       std::cout << "Retrying in 5 seconds..." << std::endl;
-      std::this_thread::sleep_for(std::chrono::seconds(5));
+      for (int i = 0; i < 50 && is_responding_; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+      continue;
+    }
+    {
+      std::lock_guard<std::mutex> lock(clients_mutex_);
+      client->connection = connection;
+    }
+    std::cout << "iwm_slip::client_loop - connection to server " << client->host << ":" << client->port << " successful" << std::endl;
+    connected_clients_++;
+
+    wait_for_requests(connection);
+
+    connected_clients_--;
+    connection->disconnect();
+    connection->join();
+    {
+      std::lock_guard<std::mutex> lock(clients_mutex_);
+      client->connection.reset();
+    }
+    // bus thread and unit workers drop queued requests of closed connection,
+    // socket is closed when the last of them is gone, other connections are served meanwhile
+    while (connection.use_count() > 1 && is_responding_) {
+      fnEventLoop.wake();
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    connection.reset();
+    if (is_responding_) {
+      std::cout << "iwm_slip::client_loop - connection to server " << client->host << ":" << client->port << " lost" << std::endl;
     }
   }
-  std::cout << "iwm_slip::setup_spi - connection to server successful" << std::endl;
 }
 
 bool iwm_slip::req_wait_for_falling_timeout(int t)
@@ -83,19 +166,27 @@ bool iwm_slip::req_wait_for_rising_timeout(int t)
 
 uint8_t iwm_slip::iwm_phase_vector()
 {
-  // Lock the mutex before accessing the queue
-  std::lock_guard<std::mutex> lock(queue_mutex_);
-
   // Check for a new Request Packet on the transport layer
-  if (request_queue_.empty()) {
+  auto &context = bus_context_;
+  // previous request is done, its slot in the queue must not keep its connection
+  context.request.connection.reset();
+  if (!request_queue_.pop(context.request)) {
+    sp_command_mode = sp_cmd_state_t::standby;
+    return PHASE_IDLE;
+  }
+  // more requests waiting, don't let service loop sleep
+  if (!request_queue_.empty())
+    fnEventLoop.wake();
+  // emulator is gone, nobody waits for the response
+  if (!context.request.connection->is_connected()) {
+    context.request.connection.reset();
     sp_command_mode = sp_cmd_state_t::standby;
     return PHASE_IDLE;
   }
 
-  // create a Request object from the data
-  auto request_data = request_queue_.front();
-  request_queue_.pop();
-  current_request = Request::from_packet(request_data);
+  // fill the pooled Request object from the data
+  auto &request_data = context.request.data;
+  context.current_request = context.pool.from_packet(request_data);
 
   std::fill(std::begin(IWM.command_packet.data), std::end(IWM.command_packet.data), 0);
   // The request data is the raw bytes of the request object, we're only really interested in the header part
@@ -108,20 +199,29 @@ uint8_t iwm_slip::iwm_phase_vector()
 
 int iwm_slip::iwm_send_packet_spi()
 {
-  auto data = current_response->serialize();
+  auto &context = this->context();
+  auto &data = context.response_buffer;
+  context.current_response->serialize_to(data);
 
-  // Some debug to remove
-  char *msg = util_hexdump(data.data(), data.size());
-  printf("iwm_slip::iwm_send_packet_spi\nresponse data (not including SLIP):\n%s\n", msg);
-  free(msg);
+  if (util_debug_enabled(DEBUG_SUBSYS, DEBUG_LEVEL_TRACE)) {
+    char *msg = util_hexdump(data.data(), data.size());
+    Debug_printf("iwm_slip::iwm_send_packet_spi\nresponse data (not including SLIP):\n%s\n", msg);
+    free(msg);
+  }
 
-  // send the data
+  // send the data to the connection the request came from
   try {
-    connection_->send_data(data);
+    context.request.connection->send_data(data);
   } catch (const std::runtime_error& e) {
     std::cerr << "iwm_slip::iwm_send_packet_spi ERROR sending response: " << e.what() << std::endl;
   }
 
+  if (context.request.time != 0) {
+    std::lock_guard<std::mutex> lock(latency_mutex_);
+    latency_.record(fnSystem.micros() - context.request.time);
+    context.request.time = 0;
+  }
+
   return 0; // 0 is success
 }
 
@@ -131,39 +231,46 @@ void iwm_slip::spi_end()
 
 void iwm_slip::encode_packet(uint8_t source, iwm_packet_type_t packet_type, uint8_t status, const uint8_t* data, uint16_t num)
 {
-  std::cout << "\niwm_slip::encode_packet\nsource: " << static_cast<unsigned int>(source) << ", packet type: " << ipt2str(packet_type) << ", status: " << static_cast<unsigned int>(status) << ", num: " << static_cast<unsigned int>(num) << std::endl;
-  if (num > 0) {
-    char *msg = util_hexdump(data, num);
-    printf("%s\n", msg);
-    free(msg);
+  if (util_debug_enabled(DEBUG_SUBSYS, DEBUG_LEVEL_TRACE)) {
+    Debug_printf("\niwm_slip::encode_packet\nsource: %u, packet type: %s, status: %u, num: %u\n",
+      source, ipt2str(packet_type).c_str(), status, num);
+    if (num > 0) {
+      char *msg = util_hexdump(data, num);
+      Debug_printf("%s\n", msg);
+      free(msg);
+    }
   }
 
   // Create response object from data being given
-  current_response = current_request->create_response(source, status, data, num);
+  auto &context = this->context();
+  context.current_response = context.current_request->create_response(source, status, data, num);
 }
 
 size_t iwm_slip::decode_data_packet(uint8_t* output_data)
 {
   // Used to get the payload data into output_data.
   // this is Request specific, e.g. WriteBlock is 512 bytes, Control is the Control List data, etc
-  current_request->copy_payload(output_data);
-
-  auto payload_size = current_request->payload_size();
-  std::cout << "\niwm_slip::decode_data_packet\nrequest payload size: " << payload_size << ", data:" << std::endl;
-  if (payload_size > 0) {
-    char *msg = util_hexdump(output_data, payload_size);
-    printf("%s\n", msg);
-    free(msg);
+  auto &context = this->context();
+  context.current_request->copy_payload(output_data);
+
+  auto payload_size = context.current_request->payload_size();
+  if (util_debug_enabled(DEBUG_SUBSYS, DEBUG_LEVEL_TRACE)) {
+    Debug_printf("\niwm_slip::decode_data_packet\nrequest payload size: %zu, data:\n", payload_size);
+    if (payload_size > 0) {
+      char *msg = util_hexdump(output_data, payload_size);
+      Debug_printf("%s\n", msg);
+      free(msg);
+    }
   }
 
-  return current_request->payload_size();
+  return payload_size;
 }
 
 size_t iwm_slip::decode_data_packet(uint8_t* input_data, uint8_t* output_data)
 {
   // Used to create the initial "command" for the request into output_data.
   // We can ignore the input_data, we already have current_request, which can write the appropriate command data to output_data
-  current_request->create_command(output_data);
+  context().current_request->create_command(output_data);
   return 0; // unused
 }
 
@@ -176,15 +283,17 @@ void iwm_slip::close_connection(int sock) {
 #endif
 }
 
-bool iwm_slip::connect_to_server(std::string host, int port)
+std::shared_ptr<Connection> iwm_slip::connect_to_server(const std::string &host, int port)
 {
   int sock;
+  bool udp = Config.get_boip_udp();
+  int sock_type = udp ? SOCK_DGRAM : SOCK_STREAM;
 #ifdef _WIN32
   WSADATA wsa_data;
   WSAStartup(MAKEWORD(2, 2), &wsa_data);
-  if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == INVALID_SOCKET) {
+  if ((sock = socket(AF_INET, sock_type, 0)) == INVALID_SOCKET) {
 #else
-  if ((sock = socket(AF_INET, SOCK_STREAM, 0)) == 0) {
+  if ((sock = socket(AF_INET, sock_type, 0)) < 0) {
 #endif
     std::ostringstream msg;
     msg << "A socket could not be created.";
@@ -206,34 +315,132 @@ bool iwm_slip::connect_to_server(std::string host, int port)
 
   if (connect(sock, reinterpret_cast<sockaddr*>(&server_addr), sizeof(server_addr)) < 0) {
     close_connection(sock);
-    return false;
+    return nullptr;
   }
 
-  std::shared_ptr<Connection> conn = std::make_shared<TCPConnection>(sock);
+  // for UDP connect only sets the peer address, datagrams go there and only its datagrams are received
+  std::shared_ptr<Connection> conn;
+  if (udp) {
+    conn = std::make_shared<UDPConnection>(sock);
+  } else {
+    conn = std::make_shared<TCPConnection>(sock);
+  }
   conn->set_is_connected(true);
   conn->create_read_channel();
+  return conn;
+}
+
+void iwm_slip::wait_for_requests(const std::shared_ptr<Connection> &connection) {
+  // buffers of request circulate between connection, queue and bus thread
+  slip_request_t request;
+  while (is_responding_ && connection->is_connected()) {
+    if (connection->wait_for_request(request.data) && !request.data.empty()) {
+      if (util_debug_enabled(DEBUG_SUBSYS, DEBUG_LEVEL_TRACE)) {
+        char *msg = util_hexdump(request.data.data(), request.data.size());
+        Debug_printf("\nNEW Request data:\n%s\n", msg);
+        free(msg);
+      }
+
+      request.time = fnSystem.micros();
+      request.connection = connection;
+      // bus thread is behind, wait for it
+      while (!request_queue_.push(request) && is_responding_)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      request.connection.reset();
+      fnEventLoop.wake();
+    }
+  }
+}
 
-  connection_ = conn;
+void iwm_slip::dispatch(iwmDevice *device, bool block_device)
+{
+  auto &request = bus_context_.request;
+  size_t lane = block_device ? SLIP_DISK_LANE : IWM.command_packet.dest;
+  auto &worker = units_[lane];
+  if (worker == nullptr) {
+    worker = std::make_unique<slip_unit_worker_t>();
+    worker->thread = std::thread(&iwm_slip::unit_loop, this, worker.get());
+  }
 
-  is_responding_ = true;
-  request_thread_ = std::thread(&iwm_slip::wait_for_requests, this);
-  return true;
+  request.device = device;
+  worker->pending++;
+  // worker is behind, keep order of its requests without stalling other units
+  if (worker->overflowed > 0 || !worker->queue.push(request)) {
+    worker->overflowed++;
+    worker->overflow.push(std::move(request));
+  }
+  request.connection.reset();
+  {
+    std::lock_guard<std::mutex> lock(worker->mutex);
+  }
+  worker->cv.notify_one();
 }
 
-void iwm_slip::wait_for_requests() {
-  while (is_responding_) {
-    auto request_data = connection_->wait_for_request();
-    if (!request_data.empty()) {
-      char *msg = util_hexdump(request_data.data(), request_data.size());
-      printf("\nNEW Request data:\n%s\n", msg);
-      free(msg);
+void iwm_slip::wait_for_units()
+{
+  std::unique_lock<std::mutex> lock(units_idle_mutex_);
+  units_idle_cv_.wait(lock, [this]() {
+    for (auto &worker : units_) {
+      if (worker != nullptr && worker->pending > 0)
+        return false;
+    }
+    return true;
+  });
+}
+
+void iwm_slip::unit_loop(slip_unit_worker_t *worker)
+{
+  // encode_packet, decode_data_packet and iwm_send_packet_spi called by device use this
+  slip_context_t context;
+  worker_context_ = &context;
+  iwm_decoded_cmd_t command;
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(worker->mutex);
+      worker->cv.wait(lock, [&]() { return !worker->queue.empty() || !worker->overflow.empty() || !is_responding_; });
+    }
+    // overflow holds newer requests than queue
+    if (!worker->queue.pop(context.request)) {
+      if (!worker->overflow.pop(context.request)) {
+        if (!is_responding_)
+          break;
+        continue;
+      }
+      worker->overflowed--;
+    }
+
+    // emulator is gone, nobody waits for the response
+    if (context.request.connection->is_connected()) {
+      context.current_request = context.pool.from_packet(context.request.data);
+      memset(command.decoded, 0, sizeof(command.decoded));
+      context.current_request->create_command(command.decoded);
+      context.request.device->process(command);
+    }
+    context.request.connection.reset();
 
-      std::lock_guard<std::mutex> lock(queue_mutex_);
-      request_queue_.push(request_data);
+    if (--worker->pending == 0) {
+      {
+        std::lock_guard<std::mutex> lock(units_idle_mutex_);
+      }
+      units_idle_cv_.notify_all();
     }
   }
 }
 
+std::string iwm_slip::latency_json(bool reset)
+{
+  std::lock_guard<std::mutex> lock(latency_mutex_);
+  char buf[200];
+  snprintf(buf, sizeof(buf), "{\"unit\": \"us\", \"count\": %llu, \"p50\": %llu, \"p95\": %llu, \"p99\": %llu, \"max\": %llu}\n",
+    (unsigned long long)latency_.count(), (unsigned long long)latency_.percentile(50.0),
+    (unsigned long long)latency_.percentile(95.0), (unsigned long long)latency_.percentile(99.0),
+    (unsigned long long)latency_.max());
+  if (reset)
+    latency_.reset();
+  return buf;
+}
+
 iwm_slip smartport;
 
 #endif
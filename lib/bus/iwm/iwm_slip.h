@@ -5,16 +5,26 @@
 #include <cstdint> 
 #include <thread>
 #include <atomic>
-#include <queue>
 #include <mutex>
+#include <string>
+#include <vector>
+#include <memory>
+#include <array>
 #include <condition_variable>
 #include "Connection.h"
-#include "../../slip/Request.h"
+#include "mpsc_queue.h"
+#include "histogram.h"
+#include "../../slip/RequestPool.h"
 #include "../../slip/Response.h"
 
 #define COMMAND_LEN 8 // Read Request / Write Request
 #define PACKET_LEN  2 + 767 // Read Response
 
+#define SLIP_REQUEST_QUEUE_SIZE 16 // must be power of two
+#define SLIP_DISK_LANE          0  // block devices share host file systems, they are processed in order by one worker
+
+class iwmDevice;
+
 union cmdPacket_t
 {
   struct
@@ -42,6 +52,49 @@ enum class sp_cmd_state_t
 };
 extern sp_cmd_state_t sp_command_mode;
 
+// request received from SLIP connection
+struct slip_request_t
+{
+  std::vector<uint8_t> data;
+  uint64_t time = 0; // fnSystem.micros() when received
+  std::shared_ptr<Connection> connection; // response goes back here
+  iwmDevice *device = nullptr; // processing device, when queued for a unit worker
+};
+
+// request being processed and its response, bus thread and every unit worker have their own
+struct slip_context_t
+{
+  slip_request_t request;
+  // reused for every request, owned by pool
+  RequestPool pool;
+  Request *current_request = nullptr;
+  Response *current_response = nullptr;
+  std::vector<uint8_t> response_buffer;
+};
+
+// processes requests for one SmartPort unit (or all block devices) in arrival order
+struct slip_unit_worker_t
+{
+  MpscRing<slip_request_t, SLIP_REQUEST_QUEUE_SIZE> queue;
+  // requests which didn't fit in queue, bus thread never waits for a worker
+  MpscQueue<slip_request_t> overflow;
+  std::atomic<int> overflowed{0}; // in overflow, queue is used again when it drops to 0
+  std::atomic<int> pending{0}; // queued or being processed
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::thread thread;
+};
+
+// SLIP server (emulator) we connect to, served by its own thread
+// All are served at once by the one device chain, they share its host and disk slots and mounted images
+struct slip_client_t
+{
+  std::string host;
+  int port;
+  std::shared_ptr<Connection> connection;
+  std::thread thread;
+};
+
 class iwm_slip
 {
 public:
@@ -63,20 +116,42 @@ public:
   size_t decode_data_packet(uint8_t* input_data, uint8_t* output_data);
 
   void close_connection(int sock);
-  bool connect_to_server(std::string host, int port);
-  void wait_for_requests();
+  std::shared_ptr<Connection> connect_to_server(const std::string &host, int port);
+  void client_loop(slip_client_t *client);
+  void wait_for_requests(const std::shared_ptr<Connection> &connection);
+
+  // hand current request to worker of its unit, responses are matched by sequence number
+  void dispatch(iwmDevice *device, bool block_device);
+  // wait until all unit workers are idle
+  void wait_for_units();
+  void unit_loop(slip_unit_worker_t *worker);
 
   uint8_t packet_buffer[PACKET_LEN];
   size_t packet_size;
-  std::shared_ptr<Connection> connection_;
-  std::thread request_thread_;
+  // one per configured BOIP host
+  std::vector<std::unique_ptr<slip_client_t>> clients_;
+  std::mutex clients_mutex_; // guards slip_client_t::connection
+  std::atomic<int> connected_clients_{0};
 	std::atomic<bool> is_responding_{false};
 
-  std::queue<std::vector<uint8_t>> request_queue_;
-  std::mutex queue_mutex_;
+  // filled by request thread(s), drained by bus thread
+  // requests are swapped in and out, their buffers are reused
+  MpscRing<slip_request_t, SLIP_REQUEST_QUEUE_SIZE> request_queue_;
+
+  // requests of different units are processed concurrently, created on first request for unit
+  std::array<std::unique_ptr<slip_unit_worker_t>, 256> units_;
+  std::mutex units_idle_mutex_;
+  std::condition_variable units_idle_cv_;
+
+  // request received .. response sent, in microseconds
+  Histogram latency_;
+  std::mutex latency_mutex_;
+  std::string latency_json(bool reset);
 
-  std::unique_ptr<Request> current_request;
-  std::unique_ptr<Response> current_response;
+  // context of calling thread, unit worker or bus thread
+  slip_context_t bus_context_;
+  static thread_local slip_context_t *worker_context_;
+  slip_context_t &context() { return worker_context_ != nullptr ? *worker_context_ : bus_context_; }
 
   std::string ipt2str(iwm_packet_type_t packet_type) {
     switch (packet_type) {
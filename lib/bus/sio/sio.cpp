@@ -1,6 +1,7 @@
 #ifdef BUILD_ATARI
 
 #include "sio.h"
+#include "siostats.h"
 
 #include "../../include/debug.h"
 
@@ -10,6 +11,7 @@
 #include "siocpm.h"
 
 #include "fnSystem.h"
+#include "fnEventLoop.h"
 #include "fnConfig.h"
 #include "fnDNS.h"
 // #include "led.h"
@@ -51,18 +53,16 @@ void virtualDevice::bus_to_computer(uint8_t *buf, uint16_t len, bool err)
     Debug_print("\n");
 #endif
 
-    // Write ERROR or COMPLETE status
-    if (err == true)
-        sio_error();
-    else
-        sio_complete();
-
-    // Write data frame
-    fnSioCom.write(buf, len);
-    // Write checksum
-    fnSioCom.write(sio_checksum(buf, len));
+    // Write ERROR or COMPLETE status, data frame and checksum
+    // all at once, NetSIO sends it in single message
+    fnSioStats.mark_io();
+    fnSystem.delay_microseconds(DELAY_T5);
+    fnSioCom.write_frame(err ? 'E' : 'C', buf, len, sio_checksum(buf, len));
+    fnSioStats.mark_complete();
+    Debug_println(err ? "ERROR!" : "COMPLETE!");
 
     fnSioCom.flush();
+    fnSioStats.mark_data();
 }
 
 // TODO apc: change return type to indicate valid/invalid checksum
@@ -118,6 +118,7 @@ void virtualDevice::sio_nak()
 {
     fnSioCom.write('N');
     fnSioCom.flush();
+    fnSioStats.mark_ack();
     SIO.set_command_processed(true);
     Debug_println("NAK!");
 }
@@ -128,6 +129,7 @@ void virtualDevice::sio_ack()
     fnSioCom.write('A');
     fnSystem.delay_microseconds(DELAY_T5); //?
     fnSioCom.flush();
+    fnSioStats.mark_ack();
     SIO.set_command_processed(true);
     Debug_println("ACK!");
 }
@@ -138,6 +140,7 @@ void virtualDevice::sio_late_ack()
     if (fnSioCom.get_sio_mode() == SioCom::sio_mode::NETSIO)
     {
         fnSioCom.netsio_late_sync('A');
+        fnSioStats.mark_ack();
         SIO.set_command_processed(true);
         Debug_println("ACK+!");
     }
@@ -150,16 +153,20 @@ void virtualDevice::sio_late_ack()
 // SIO COMPLETE
 void virtualDevice::sio_complete()
 {
+    fnSioStats.mark_io();
     fnSystem.delay_microseconds(DELAY_T5);
     fnSioCom.write('C');
+    fnSioStats.mark_complete();
     Debug_println("COMPLETE!");
 }
 
 // SIO ERROR
 void virtualDevice::sio_error()
 {
+    fnSioStats.mark_io();
     fnSystem.delay_microseconds(DELAY_T5);
     fnSioCom.write('E');
+    fnSioStats.mark_complete();
     Debug_println("ERROR!");
 }
 
@@ -244,6 +251,7 @@ void systemBus::_sio_process_cmd()
     uint8_t ck = sio_checksum((uint8_t *)&tempFrame.commanddata, sizeof(tempFrame.commanddata)); // Calculate Checksum
     if (ck == tempFrame.checksum)
     {
+        fnSioStats.mark_frame(tempFrame.device, tempFrame.comnd);
         _command_frame_counter = 0;
         if (tempFrame.device == SIO_DEVICEID_DISK && _fujiDev != nullptr && _fujiDev->boot_config)
         {
@@ -344,6 +352,10 @@ void systemBus::_sio_process_queue()
  */
 void systemBus::service()
 {
+    // work not driven by SIO port events, keep service loop ticking
+    if (_sio_poll_needed())
+        fnEventLoop.schedule(SIO_POLL_INTERVAL_MS);
+
     do
     {
 
@@ -416,7 +428,9 @@ void systemBus::service()
         unsigned long startms = fnSystem.millis();
         Debug_print("\n");
 
+        fnSioStats.mark_start(fnSioCom.command_time());
         _sio_process_cmd();
+        fnSioStats.mark_end(_command_processed);
 
         unsigned long endms = fnSystem.millis();
         if (_command_processed)
@@ -448,6 +462,23 @@ void systemBus::service()
     } while (fnSioCom.poll(1));
 }
 
+// Anything to be polled regularly besides the SIO port?
+bool systemBus::_sio_poll_needed()
+{
+    if (_cpmDev != nullptr && _cpmDev->cpmActive && Config.get_cpm_enabled())
+        return true;
+    if (_fujiDev != nullptr && _fujiDev->cassette()->is_mounted() && Config.get_cassette_enabled())
+        return true;
+    if (_modemDev != nullptr && _modemDev->modemActive)
+        return true;
+    for (int i = 0; i < 8; i++)
+    {
+        if (_netDev[i] != nullptr && _netDev[i]->sio_poll_needed())
+            return true;
+    }
+    return false;
+}
+
 // Setup SIO bus
 void systemBus::setup()
 {
@@ -457,6 +488,9 @@ void systemBus::setup()
     fnSioCom.set_serial_port(Config.get_serial_port().c_str(), Config.get_serial_command(), Config.get_serial_proceed()); // UART
     fnSioCom.set_netsio_host(Config.get_netsio_host().c_str(), Config.get_netsio_port()); // NetSIO
     fnSioCom.set_sio_mode(Config.get_netsio_enabled() ? SioCom::sio_mode::NETSIO : SioCom::sio_mode::SERIAL);
+    // precise T4/T5 delays for physical SIO
+    if (Config.get_serial_precise_timing())
+        fnSystem.set_delay_mode(SystemManager::DELAY_MODE_PRECISE);
     fnSioCom.begin(_sioBaud);
 
     fnSioCom.set_interrupt(false);
@@ -49,6 +49,8 @@ FN_HISPEED_INDEX=40 //  18,806 (18,806) baud
 
 #define COMMAND_FRAME_SPEED_CHANGE_THRESHOLD 2
 #define SERIAL_TIMEOUT 300
+// service loop tick while network interrupts, modem, CP/M or cassette need polling
+#define SIO_POLL_INTERVAL_MS 1
 
 #define SIO_DEVICEID_DISK 0x31
 #define SIO_DEVICEID_DISK_LAST 0x3F
@@ -266,6 +268,7 @@ private:
 
     void _sio_process_cmd();
     void _sio_process_queue();
+    bool _sio_poll_needed();
 
 public:
     void setup();
@@ -53,6 +53,11 @@ bool SioCom::command_asserted()
     return _sioPort->command_asserted();
 }
 
+uint64_t SioCom::command_time()
+{
+    return _sioPort->command_time();
+}
+
 bool SioCom::motor_asserted() 
 {
     return _sioPort->motor_asserted();
@@ -119,6 +124,12 @@ ssize_t SioCom::write(const char *str)
     return _sioPort->write((const uint8_t *)str, strlen(str));
 };
 
+// write status byte, data frame and checksum
+ssize_t SioCom::write_frame(uint8_t status, const uint8_t *buffer, size_t size, uint8_t checksum)
+{
+    return _sioPort->write_frame(status, buffer, size, checksum);
+}
+
 // print utility functions
 
 size_t SioCom::_print_number(unsigned long n, uint8_t base)
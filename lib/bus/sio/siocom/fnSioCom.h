@@ -43,6 +43,7 @@ public:
     uint32_t get_baudrate();
 
     bool command_asserted();
+    uint64_t command_time();
     bool motor_asserted();
     void set_proceed(bool level);
     void set_interrupt(bool level);
@@ -64,6 +65,8 @@ public:
     ssize_t write(const uint8_t *buffer, size_t size);
     // write C-string
     ssize_t write(const char *str);
+    // write status byte (COMPLETE/ERROR), data frame and checksum
+    ssize_t write_frame(uint8_t status, const uint8_t *buffer, size_t size, uint8_t checksum);
 
     // print utility functions
     size_t print(const char *str);
@@ -16,6 +16,7 @@
 
 #include "fnSystem.h"
 #include "fnWiFi.h"
+#include "fnEventLoop.h"
 
 
 /* alive response timeout in seconds
@@ -41,6 +42,8 @@ NetSioPort::NetSioPort() :
     _rxhead(0),
     _rxtail(0),
     _rxfull(false),
+    _rxmsg_count(0),
+    _rxmsg_next(0),
     _sync_request_num(-1),
     _sync_write_size(-1),
     _errcount(0),
@@ -64,6 +67,7 @@ void NetSioPort::begin(int baud)
     _command_asserted = false;
     _motor_asserted = false;
     rxbuffer_flush();
+    _rxmsg_count = _rxmsg_next = 0;
 
     // Wait for WiFi
     int suspend_ms = _errcount < 5 ? 400 : 2000;
@@ -143,6 +147,8 @@ void NetSioPort::begin(int baud)
     _initialized = true;
     _errcount = 0;
     set_baudrate(baud);
+    // wake up service loop on incoming NetSIO messages
+    fnEventLoop.add_fd(_fd);
 }
 
 void NetSioPort::end()
@@ -151,6 +157,7 @@ void NetSioPort::end()
     {
         uint8_t disconnect = NETSIO_DEVICE_DISCONNECT;
         send(_fd, (char *)&disconnect, 1, 0);
+        fnEventLoop.remove_fd(_fd);
         closesocket(_fd);
         _fd  = -1;
         fnSystem.delay(50); // wait a while, otherwise wifi may turn off too quickly (during shutdown)
@@ -257,6 +264,71 @@ int NetSioPort::rxbuffer_get()
     return b;
 }
 
+/* put block of bytes into buffer, returns true on overrun */
+bool NetSioPort::rxbuffer_write(const uint8_t *buf, size_t len)
+{
+    bool overrun = false;
+    size_t chunk;
+
+    if (len == 0)
+        return false;
+
+    // only the last sizeof(_rxbuf) bytes can be kept
+    if (len > sizeof(_rxbuf))
+    {
+        buf += len - sizeof(_rxbuf);
+        len = sizeof(_rxbuf);
+        overrun = true;
+    }
+    if (len > sizeof(_rxbuf) - rxbuffer_available())
+        overrun = true;
+
+    while (len > 0)
+    {
+        chunk = sizeof(_rxbuf) - _rxhead;
+        if (chunk > len)
+            chunk = len;
+        memcpy(_rxbuf + _rxhead, buf, chunk);
+        _rxhead = (_rxhead + chunk) % sizeof(_rxbuf);
+        buf += chunk;
+        len -= chunk;
+    }
+
+    if (overrun)
+    {
+        // oldest bytes were overwritten / lost
+        _rxtail = _rxhead;
+        _rxfull = true;
+    }
+    else
+        _rxfull = (_rxhead == _rxtail);
+    return overrun;
+}
+
+/* get up to len bytes from buffer, returns number of bytes copied */
+size_t NetSioPort::rxbuffer_read(uint8_t *buf, size_t len)
+{
+    size_t avail = rxbuffer_available();
+    size_t chunk;
+    size_t count = 0;
+
+    if (len > avail)
+        len = avail;
+
+    while (count < len)
+    {
+        chunk = sizeof(_rxbuf) - _rxtail;
+        if (chunk > len - count)
+            chunk = len - count;
+        memcpy(buf + count, _rxbuf + _rxtail, chunk);
+        _rxtail = (_rxtail + chunk) % sizeof(_rxbuf);
+        count += chunk;
+    }
+    if (count > 0)
+        _rxfull = false;
+    return count;
+}
+
 int  NetSioPort::rxbuffer_available() 
 {
     int avail = _rxhead - _rxtail;
@@ -323,106 +395,172 @@ bool NetSioPort::keep_alive()
     return _initialized;
 }
 
-/* read NetSIO message from socket and update internal variables */
+/* receive pending NetSIO messages from socket, up to NETSIO_RX_BATCH at once
+ * returns number of datagrams received
+ */
+int NetSioPort::rxqueue_fill()
+{
+    _rxmsg_count = _rxmsg_next = 0;
+
+#if defined(__linux__)
+    struct mmsghdr msgs[NETSIO_RX_BATCH];
+    struct iovec iovs[NETSIO_RX_BATCH];
+
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < NETSIO_RX_BATCH; i++)
+    {
+        iovs[i].iov_base = _rxmsg_buf[i];
+        iovs[i].iov_len = NETSIO_RX_MSG_SIZE;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int count = recvmmsg(_fd, msgs, NETSIO_RX_BATCH, MSG_DONTWAIT, nullptr);
+    if (count <= 0)
+        return 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        if (msgs[i].msg_len > 0)
+            _rxmsg_len[_rxmsg_count++] = msgs[i].msg_len;
+    }
+#else
+    int received = recv(_fd, (char *)_rxmsg_buf[0], NETSIO_RX_MSG_SIZE, 0);
+    if (received > 0)
+        _rxmsg_len[_rxmsg_count++] = received;
+#endif
+
+    return _rxmsg_count;
+}
+
+/* read NetSIO messages from socket and update internal variables
+ * all received messages are processed at once, up to first message which changes
+ * state of SIO lines or requests sync, the caller must have a chance to see it
+ */
 int NetSioPort::handle_netsio()
 {
-    uint8_t rxbuf[514]; // must be able to hold whole netsio datagram, i.e. >= rxbuffer_len+2 defined in netsio.atdevice
-    uint8_t b;
-    int received;
+    int received = 0;
+    bool more;
 
     if (!resume_test())
         return 0;
 
-    received = recv(_fd, (char *)rxbuf, sizeof(rxbuf), 0);
-    if (received > 0)
+    do
     {
+        if (_rxmsg_next >= _rxmsg_count && rxqueue_fill() == 0)
+            break;
+        int len = _rxmsg_len[_rxmsg_next];
+        more = process_message(_rxmsg_buf[_rxmsg_next++], len);
+        received += len;
+    } while (more && _initialized);
+
+    keep_alive();
+
+    return received;
+}
+
+/* process single NetSIO message
+ * returns true if next message can be processed right away
+ */
+bool NetSioPort::process_message(uint8_t *msg, int len)
+{
+    bool more = false;
+
 #ifdef VERBOSE_SIO
-        Debug_printf("NetSIO RECV <%i> BYTES\n\t", received);
-        for (int i = 0; i < received; i++)
-            Debug_printf("%02x ", rxbuf[i]);
-        Debug_print("\n");
+    Debug_printf("NetSIO RECV <%i> BYTES\n\t", len);
+    for (int i = 0; i < len; i++)
+        Debug_printf("%02x ", msg[i]);
+    Debug_print("\n");
 #endif
-        _alive_time = fnSystem.millis(); // update last received
-        switch (rxbuf[0])
-        {
-            case NETSIO_DATA_BYTE_SYNC:
-                if (received >= 3)
-                    _sync_request_num = rxbuf[2];
-                // [[fallthrough]]; // > No warning
-
-            case NETSIO_DATA_BYTE:
-                b = rxbuf[1];
-                if (_baud_peer < _baud * 95 / 100 || _baud_peer > _baud * 105 / 100)
-                    b ^= (uint8_t)_baud_peer ^ (uint8_t)_baud; // corrupt byte
-                if (rxbuffer_put(b))
-                    Debug_println("NetSIO rxbuffer overrun");
-                break;
+    _alive_time = fnSystem.millis(); // update last received
+
+    // on baudrate mismatch data bytes are corrupted
+    uint8_t corrupt = 0;
+    if (_baud_peer < _baud * 95 / 100 || _baud_peer > _baud * 105 / 100)
+        corrupt = (uint8_t)_baud_peer ^ (uint8_t)_baud;
+
+    switch (msg[0])
+    {
+        case NETSIO_DATA_BYTE_SYNC:
+            if (len >= 3)
+                _sync_request_num = msg[2];
+            msg[1] ^= corrupt;
+            if (rxbuffer_put(msg[1]))
+                Debug_println("NetSIO rxbuffer overrun");
+            break;
+
+        case NETSIO_DATA_BYTE:
+            msg[1] ^= corrupt;
+            if (rxbuffer_put(msg[1]))
+                Debug_println("NetSIO rxbuffer overrun");
+            more = true;
+            break;
 
-            case NETSIO_DATA_BLOCK:
-                if (received >= 2)
+        case NETSIO_DATA_BLOCK:
+            if (len >= 2)
+            {
+                // TODO len-2, to test packet SNs
+                if (corrupt)
                 {
-                    for (int i = 1; i < received-1; i++) // TODO received-1, to test packet SNs
-                    // for (int i = 1; i < received; i++)
-                    {
-                        b = rxbuf[i];
-                        if (_baud_peer < _baud * 95 / 100 || _baud_peer > _baud * 105 / 100)
-                            b ^= (uint8_t)_baud_peer ^ (uint8_t)_baud; // corrupt byte
-                        if (rxbuffer_put(b))
-                            Debug_println("NetSIO rxbuffer overrun");
-                    }
+                    for (int i = 1; i < len-1; i++)
+                        msg[i] ^= corrupt;
                 }
-                break;
+                if (rxbuffer_write(msg+1, len-2))
+                    Debug_println("NetSIO rxbuffer overrun");
+            }
+            more = true;
+            break;
 
-            case NETSIO_COMMAND_OFF_SYNC:
-                if (received >= 2) 
-                    _sync_request_num = rxbuf[1]; // sync request sequence number
-                // [[fallthrough]]; // > No warning
+        case NETSIO_COMMAND_OFF_SYNC:
+            if (len >= 2)
+                _sync_request_num = msg[1]; // sync request sequence number
+            // [[fallthrough]]; // > No warning
 
-            case NETSIO_COMMAND_OFF:
-                _command_asserted = false;
-                break;
+        case NETSIO_COMMAND_OFF:
+            _command_asserted = false;
+            break;
 
-            case NETSIO_COMMAND_ON:
-                _command_asserted = true;
-                _sync_request_num = -1; // cancel any sync request
-                _sync_write_size = -1;
-                rxbuffer_flush();   // flush any stray input data
-                break;
+        case NETSIO_COMMAND_ON:
+            _command_asserted = true;
+            _sync_request_num = -1; // cancel any sync request
+            _sync_write_size = -1;
+            rxbuffer_flush();   // flush any stray input data
+            break;
 
-            case NETSIO_MOTOR_OFF:
-                _motor_asserted = false;
-                break;
+        case NETSIO_MOTOR_OFF:
+            _motor_asserted = false;
+            break;
 
-            case NETSIO_MOTOR_ON:
-                _motor_asserted = true;
-                break;
+        case NETSIO_MOTOR_ON:
+            _motor_asserted = true;
+            break;
 
-            case NETSIO_SPEED_CHANGE:
-                // speed change notification
-                if (received >= 5)
-                {
-                    _baud_peer = rxbuf[1] | (rxbuf[2] << 8) | (rxbuf[3] << 16) | (rxbuf[4] << 24);
-                    Debug_printf("NetSIO peer baudrate: %d\n", _baud_peer);
-                }
-                break;
+        case NETSIO_SPEED_CHANGE:
+            // speed change notification
+            if (len >= 5)
+            {
+                _baud_peer = msg[1] | (msg[2] << 8) | (msg[3] << 16) | (msg[4] << 24);
+                Debug_printf("NetSIO peer baudrate: %d\n", _baud_peer);
+            }
+            more = true;
+            break;
 
-            case NETSIO_CREDIT_UPDATE:
-                _credit = rxbuf[1];
-                break;
+        case NETSIO_CREDIT_UPDATE:
+            _credit = msg[1];
+            more = true;
+            break;
 
-            case NETSIO_COLD_RESET:
-                // emulator cold reset, do fujinet restart
-                fnSystem.reboot();
-                break;
+        case NETSIO_COLD_RESET:
+            // emulator cold reset, do fujinet restart
+            fnSystem.reboot();
+            break;
 
-            default:
-                break;
-        }
+        default:
+            more = true;
+            break;
     }
 
-    keep_alive();
-
-    return received;
+    return more;
 }
 
 timeval NetSioPort::timeval_from_ms(const uint32_t millis)
@@ -438,7 +576,11 @@ bool NetSioPort::wait_sock_readable(uint32_t timeout_ms)
     timeval timeout_tv;
     fd_set readfds;
     int result;
-    
+
+    // already received message(s) waiting to be processed
+    if (_rxmsg_next < _rxmsg_count)
+        return true;
+
     for(;;)
     {
         // Setup a select call to block for socket data or a timeout
@@ -711,26 +853,16 @@ size_t NetSioPort::read(uint8_t *buffer, size_t length, bool command_mode)
         // 850 us pre-ACK delay will be added by netsio.atdevice
     }
 
-    int result;
-    int rxbytes;
+    size_t rxbytes;
     for (rxbytes=0; rxbytes<length;)
     {
-        result = read();
-        // Debug_printf("read: %d\n", result);
-        if (result < 0)
+        if (!wait_for_data(500))
         {
+            Debug_println("NetSIO read() - TIMEOUT");
             break;
         }
-        else
-        {
-            buffer[rxbytes++] = (uint8_t)result;
-        }
-
-        if (rxbytes == length)
-        {
-            // done
-            break;
-        }
+        // take everything available at once
+        rxbytes += rxbuffer_read(buffer + rxbytes, length - rxbytes);
 
         // // wait for more data
         // if (command_mode && !command_asserted())
@@ -810,6 +942,32 @@ ssize_t NetSioPort::write(const uint8_t *buffer, size_t size)
     return txbytes;
 }
 
+/* write status byte (COMPLETE/ERROR), data frame and checksum as one NETSIO_DATA_BLOCK
+ * instead of three messages, each waiting for credit from the hub
+ */
+ssize_t NetSioPort::write_frame(uint8_t status, const uint8_t *buffer, size_t size, uint8_t checksum)
+{
+    uint8_t txbuf[513];
+
+    if (!_initialized)
+        return 0;
+
+    // status byte must be bundled in sync response if sync is pending
+    // or frame does not fit into single datagram, send it piece by piece
+    if (_sync_request_num >= 0 || size + 3 > sizeof(txbuf))
+        return SioPort::write_frame(status, buffer, size, checksum);
+
+    txbuf[0] = NETSIO_DATA_BLOCK;
+    txbuf[1] = status;
+    memcpy(txbuf+2, buffer, size);
+    txbuf[size+2] = checksum;
+
+    if (!wait_for_credit(1))
+        return 0;
+    ssize_t result = write_sock(txbuf, size+3);
+    return (result > 0) ? result-1 : 0; // amount of bytes written
+}
+
 // specific to NetSioPort
 void NetSioPort::set_host(const char *host, int port)
 {
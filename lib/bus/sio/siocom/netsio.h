@@ -5,6 +5,11 @@
 #include "fnDNS.h"
 #include <sys/time.h>
 
+// max number of datagrams received at once
+#define NETSIO_RX_BATCH     16
+// must be able to hold whole netsio datagram, i.e. >= rxbuffer_len+2 defined in netsio.atdevice
+#define NETSIO_RX_MSG_SIZE  514
+
 class NetSioPort : public SioPort
 {
 private:
@@ -24,6 +29,12 @@ private:
     int _rxtail;
     bool _rxfull;
 
+    // received but not yet processed datagrams
+    uint8_t _rxmsg_buf[NETSIO_RX_BATCH][NETSIO_RX_MSG_SIZE];
+    int _rxmsg_len[NETSIO_RX_BATCH];
+    int _rxmsg_count;
+    int _rxmsg_next;
+
     int _sync_request_num;  // 0..255 sync request sequence number, -1 if sync is not requested
     uint8_t _sync_ack_byte; // ACK byte to send with sync response
     int _sync_write_size;   // 0 .. no SIO write (from computer), > 0 .. expected bytes written
@@ -42,6 +53,8 @@ protected:
     bool keep_alive();
 
     int handle_netsio();
+    bool process_message(uint8_t *msg, int len);
+    int rxqueue_fill();
     static timeval timeval_from_ms(const uint32_t millis);
 
     bool wait_sock_readable(uint32_t timeout_ms);
@@ -54,6 +67,8 @@ protected:
     bool rxbuffer_empty();
     bool rxbuffer_put(uint8_t b);
     int rxbuffer_get();
+    bool rxbuffer_write(const uint8_t *buf, size_t len);
+    size_t rxbuffer_read(uint8_t *buf, size_t len);
     int rxbuffer_available();
     void rxbuffer_flush();
 
@@ -85,6 +100,8 @@ public:
     virtual ssize_t write(uint8_t b) override;
     // write buffer
     virtual ssize_t write(const uint8_t *buffer, size_t size) override;
+    // write status byte, data frame and checksum in single datagram
+    virtual ssize_t write_frame(uint8_t status, const uint8_t *buffer, size_t size, uint8_t checksum) override;
 
     // specific to NetSioPort
     void set_host(const char *host, int port);
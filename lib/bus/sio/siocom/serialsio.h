@@ -25,6 +25,7 @@ public:
     virtual uint32_t get_baudrate() override { return _uart.get_baudrate(); }
 
     virtual bool command_asserted() override { return _uart.command_asserted(); }
+    virtual uint64_t command_time() override { return _uart.command_time(); }
     virtual bool motor_asserted() override { return _uart.motor_asserted(); }
     virtual void set_proceed(bool level) override { _uart.set_proceed(level); }
     virtual void set_interrupt(bool level) override { _uart.set_interrupt(level); }
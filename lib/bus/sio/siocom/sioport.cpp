@@ -1,2 +1,13 @@
 
 #include "sioport.h"
+
+/* Default frame write, status, data and checksum are sent one after another
+ * Ports which can send it more efficiently should override it
+ */
+ssize_t SioPort::write_frame(uint8_t status, const uint8_t *buffer, size_t size, uint8_t checksum)
+{
+    ssize_t txbytes = write(status);
+    txbytes += write(buffer, size);
+    txbytes += write(checksum);
+    return txbytes;
+}
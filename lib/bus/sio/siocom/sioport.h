@@ -22,6 +22,8 @@ public:
     virtual uint32_t get_baudrate() = 0;
 
     virtual bool command_asserted() = 0;
+    // time (fnSystem.micros) of last COMMAND assert, 0 if port can't tell
+    virtual uint64_t command_time() { return 0; }
     virtual bool motor_asserted() = 0;
     virtual void set_proceed(bool level) = 0;
     virtual void set_interrupt(bool level) = 0;
@@ -35,6 +37,8 @@ public:
 
     virtual ssize_t write(uint8_t b) = 0; // write single byte
     virtual ssize_t write(const uint8_t *buffer, size_t size) = 0; // write buffer
+    // write status byte (COMPLETE/ERROR), data frame and checksum
+    virtual ssize_t write_frame(uint8_t status, const uint8_t *buffer, size_t size, uint8_t checksum);
 };
 
 #endif // SIOPORT_H
@@ -0,0 +1,134 @@
+#ifdef BUILD_ATARI
+
+#include "siostats.h"
+
+#include <stdio.h>
+
+#include "fnSystem.h"
+
+SioStats fnSioStats;
+
+const char *SioStats::phase_name(int phase)
+{
+    switch (phase)
+    {
+    case SIO_PHASE_FRAME:
+        return "frame";
+    case SIO_PHASE_ACK:
+        return "ack";
+    case SIO_PHASE_IO:
+        return "io";
+    case SIO_PHASE_COMPLETE:
+        return "complete";
+    case SIO_PHASE_DATA:
+        return "data";
+    default:
+        return "total";
+    }
+}
+
+void SioStats::mark_start(uint64_t t_start)
+{
+    uint64_t now = fnSystem.micros();
+    // ignore stale edge time (i.e. not from this command)
+    _t_start = (t_start != 0 && t_start <= now && now - t_start < 100000) ? t_start : now;
+    _t_frame = _t_ack = _t_io = _t_complete = _t_data = 0;
+}
+
+void SioStats::mark_frame(uint8_t device, uint8_t command)
+{
+    _t_frame = fnSystem.micros();
+    _device = device;
+    _command = command;
+}
+
+void SioStats::mark_ack()
+{
+    if (_t_ack == 0)
+        _t_ack = fnSystem.micros();
+}
+
+void SioStats::mark_io()
+{
+    if (_t_io == 0)
+        _t_io = fnSystem.micros();
+}
+
+void SioStats::mark_complete()
+{
+    if (_t_complete == 0)
+        _t_complete = fnSystem.micros();
+}
+
+void SioStats::mark_data()
+{
+    _t_data = fnSystem.micros();
+}
+
+void SioStats::mark_end(bool processed)
+{
+    uint64_t t_end = fnSystem.micros();
+
+    // only commands handled by some device are of interest
+    if (!processed || _t_start == 0 || _t_frame == 0)
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    cmd_stats &cs = _stats[(uint16_t)(_device << 8 | _command)];
+
+    // each phase is measured from the last reached mark
+    uint64_t last = _t_start;
+    uint64_t marks[SIO_PHASE_TOTAL] = {_t_frame, _t_ack, _t_io, _t_complete, _t_data};
+    for (int i = 0; i < SIO_PHASE_TOTAL; i++)
+    {
+        if (marks[i] == 0)
+            continue;
+        cs.phase[i].record(marks[i] - last);
+        last = marks[i];
+    }
+    cs.phase[SIO_PHASE_TOTAL].record(t_end - _t_start);
+
+    _t_start = 0;
+}
+
+void SioStats::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.clear();
+}
+
+std::string SioStats::to_json()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::string json = "{\"unit\": \"us\", \"commands\": [";
+    char buf[160];
+    bool first_cmd = true;
+
+    for (auto &it : _stats)
+    {
+        snprintf(buf, sizeof(buf), "%s\n{\"device\": \"%02x\", \"command\": \"%02x\", \"count\": %llu, \"phases\": {",
+            first_cmd ? "" : ",", it.first >> 8, it.first & 0xff,
+            (unsigned long long)it.second.phase[SIO_PHASE_TOTAL].count());
+        json += buf;
+        first_cmd = false;
+
+        bool first_phase = true;
+        for (int i = 0; i < SIO_PHASE_COUNT; i++)
+        {
+            const Histogram &h = it.second.phase[i];
+            if (h.count() == 0)
+                continue;
+            snprintf(buf, sizeof(buf), "%s\"%s\": {\"p50\": %llu, \"p95\": %llu, \"p99\": %llu, \"max\": %llu}",
+                first_phase ? "" : ", ", phase_name(i),
+                (unsigned long long)h.percentile(50.0), (unsigned long long)h.percentile(95.0),
+                (unsigned long long)h.percentile(99.0), (unsigned long long)h.max());
+            json += buf;
+            first_phase = false;
+        }
+        json += "}}";
+    }
+    json += "\n]}\n";
+    return json;
+}
+
+#endif /* BUILD_ATARI */
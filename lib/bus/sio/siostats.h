@@ -0,0 +1,78 @@
+#ifndef SIOSTATS_H
+#define SIOSTATS_H
+
+#include <stdint.h>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "histogram.h"
+
+/*
+ * SIO command timing statistics
+ * Every processed command is split into phases, duration of each phase
+ * (in microseconds) is recorded into histogram kept per device and command.
+ *
+ *   frame    - COMMAND asserted .. command frame received
+ *   ack      - command frame received .. ACK (or NAK) sent
+ *   io       - ACK sent .. device is ready to send COMPLETE/ERROR (media/network I/O)
+ *   complete - COMPLETE/ERROR sent (incl. T5 delay)
+ *   data     - status sent .. data frame flushed
+ *   total    - COMMAND asserted .. command processing finished
+ */
+
+enum sio_phase
+{
+    SIO_PHASE_FRAME = 0,
+    SIO_PHASE_ACK,
+    SIO_PHASE_IO,
+    SIO_PHASE_COMPLETE,
+    SIO_PHASE_DATA,
+    SIO_PHASE_TOTAL,
+    SIO_PHASE_COUNT
+};
+
+class SioStats
+{
+private:
+    struct cmd_stats
+    {
+        Histogram phase[SIO_PHASE_COUNT];
+    };
+
+    // key: device << 8 | command
+    std::map<uint16_t, cmd_stats> _stats;
+    std::mutex _mutex;
+
+    // timestamps of currently processed command, 0 if not reached
+    uint64_t _t_start = 0;
+    uint64_t _t_frame = 0;
+    uint64_t _t_ack = 0;
+    uint64_t _t_io = 0;
+    uint64_t _t_complete = 0;
+    uint64_t _t_data = 0;
+    uint8_t _device = 0;
+    uint8_t _command = 0;
+
+    static const char *phase_name(int phase);
+
+public:
+    // timestamps of the command phases, called from SIO bus code
+    // t_start - COMMAND assert time if known by SIO port, 0 = now
+    void mark_start(uint64_t t_start = 0);
+    void mark_frame(uint8_t device, uint8_t command);
+    void mark_ack();
+    void mark_io();
+    void mark_complete();
+    void mark_data();
+    // record phase durations of the current command
+    void mark_end(bool processed);
+
+    void reset();
+    // p50/p95/p99/max of every phase for every seen device and command
+    std::string to_json();
+};
+
+extern SioStats fnSioStats;
+
+#endif // SIOSTATS_H
@@ -114,6 +114,12 @@ public:
     void store_general_config_path(const char *file_path);
     std::string get_general_SD_path() { return _general.SD_dir_path; };
     void store_general_SD_path(const char *dir_path);
+    std::string get_general_debug_levels() { return _general.debug_levels; };
+    void store_general_debug_levels(const char *debug_levels);
+    bool get_general_write_behind() { return _general.write_behind; };
+    void store_general_write_behind(bool write_behind);
+    int get_general_read_ahead() { return _general.read_ahead; };
+    void store_general_read_ahead(int read_ahead);
 
     const char * get_network_sntpserver() { return _network.sntpserver; };
 
@@ -124,6 +130,8 @@ public:
     void store_serial_port(const char *port);
     void store_serial_command(serial_command_pin command_pin);
     void store_serial_proceed(serial_proceed_pin proceed_pin);
+    bool get_serial_precise_timing() { return _serial.precise_timing; };
+    void store_serial_precise_timing(bool precise_timing);
 
     // WIFI
     bool have_wifi_info() { return _wifi.ssid.empty() == false; };
@@ -178,7 +186,8 @@ public:
     std::string get_mount_path(uint8_t num, mount_type_t mounttype = mount_type_t::MOUNTTYPE_DISK);
     mount_mode_t get_mount_mode(uint8_t num, mount_type_t mounttype = mount_type_t::MOUNTTYPE_DISK);
     int get_mount_host_slot(uint8_t num, mount_type_t mounttype = mount_type_t::MOUNTTYPE_DISK);
-    void store_mount(uint8_t num, int hostslot, const char *path, mount_mode_t mode, mount_type_t mounttype = mount_type_t::MOUNTTYPE_DISK);
+    bool get_mount_fetch(uint8_t num);
+    void store_mount(uint8_t num, int hostslot, const char *path, mount_mode_t mode, mount_type_t mounttype = mount_type_t::MOUNTTYPE_DISK, bool fetch = false);
     void clear_mount(uint8_t num, mount_type_t mounttype = mount_type_t::MOUNTTYPE_DISK);
 
     // PRINTERS
@@ -244,9 +253,11 @@ public:
     bool get_boip_enabled() { return _boip.boip_enabled; }
     std::string get_boip_host() { return _boip.host; }
     int get_boip_port() { return _boip.port; }
+    bool get_boip_udp() { return _boip.udp; }
     void store_boip_enabled(bool enabled);
     void store_boip_host(const char *host);
     void store_boip_port(int port);
+    void store_boip_udp(bool udp);
 
     void load();
     void save();
@@ -334,6 +345,7 @@ private:
     {
         int host_slot = HOST_SLOT_INVALID;
         mount_mode_t mode = MOUNTMODE_INVALID;
+        bool fetch = false; // image copied to RAM when mounted
         std::string path;
     };
 
@@ -401,6 +413,9 @@ private:
         bool printer_enabled = true;
     #endif
         std::string interface_url = WEB_SERVER_LISTEN_URL; // default URL to serve web interface
+        std::string debug_levels; // per-subsystem debug log levels, empty for defaults
+        bool write_behind = false; // journal writes to remote disk images on SD, write them out in background
+        int read_ahead = 0; // max. sectors read ahead from disk images by sequential reads, 0 = whole track
         std::string config_file_path = CONFIG_FILENAME; // default path to load/save config file (program CWD)
         std::string SD_dir_path = SD_CARD_DIR; // default path to load/save config file
     };
@@ -410,6 +425,7 @@ private:
         std::string port;
         serial_command_pin command = SERIAL_COMMAND_DSR;
         serial_proceed_pin proceed = SERIAL_PROCEED_DTR;
+        bool precise_timing = false;
     };
 
     struct netsio_info
@@ -422,8 +438,9 @@ private:
     struct boip_info
     {
         bool boip_enabled = false;
-        std::string host = "";
+        std::string host = ""; // comma separated list of host[:port], all served at once
         int port = CONFIG_DEFAULT_BOIP_PORT;
+        bool udp = false; // transport=udp, TCP otherwise
     };
 
     struct modem_info
@@ -38,6 +38,33 @@ void fnConfig::store_general_config_enabled(bool config_enabled)
     _general.config_enabled = config_enabled;
     _dirty = true;
 }
+void fnConfig::store_general_debug_levels(const char *debug_levels)
+{
+    if (_general.debug_levels.compare(debug_levels) == 0)
+        return;
+
+    _general.debug_levels = debug_levels;
+    _dirty = true;
+}
+
+void fnConfig::store_general_write_behind(bool write_behind)
+{
+    if (_general.write_behind == write_behind)
+        return;
+
+    _general.write_behind = write_behind;
+    _dirty = true;
+}
+
+void fnConfig::store_general_read_ahead(int read_ahead)
+{
+    if (_general.read_ahead == read_ahead)
+        return;
+
+    _general.read_ahead = read_ahead;
+    _dirty = true;
+}
+
 void fnConfig::store_general_status_wait_enabled(bool status_wait_enabled)
 {
     if (_general.status_wait_enabled == status_wait_enabled)
@@ -204,6 +231,20 @@ void fnConfig::_read_section_general(std::stringstream &ss)
             {
                 _general.encrypt_passphrase = util_string_value_is_true(value);
             }
+            else if (strcasecmp(name.c_str(), "debug_levels") == 0)
+            {
+                _general.debug_levels = value;
+            }
+            else if (strcasecmp(name.c_str(), "write_behind") == 0)
+            {
+                _general.write_behind = util_string_value_is_true(value);
+            }
+            else if (strcasecmp(name.c_str(), "read_ahead") == 0)
+            {
+                int read_ahead = atoi(value.c_str());
+                if (read_ahead >= 0)
+                    _general.read_ahead = read_ahead;
+            }
         }
     }
 }
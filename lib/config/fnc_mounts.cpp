@@ -1,5 +1,6 @@
 #include "fnConfig.h"
 #include <cstring>
+#include "utils.h"
 
 std::string fnConfig::get_mount_path(uint8_t num, mount_type_t mounttype)
 {
@@ -40,16 +41,25 @@ int fnConfig::get_mount_host_slot(uint8_t num, mount_type_t mounttype)
     return HOST_SLOT_INVALID;
 }
 
-void fnConfig::store_mount(uint8_t num, int hostslot, const char *path, mount_mode_t mode, mount_type_t mounttype)
+bool fnConfig::get_mount_fetch(uint8_t num)
+{
+    if (num < MAX_MOUNT_SLOTS)
+        return _mount_slots[num].fetch;
+
+    return false;
+}
+
+void fnConfig::store_mount(uint8_t num, int hostslot, const char *path, mount_mode_t mode, mount_type_t mounttype, bool fetch)
 {
     // Handle disk slots
     if (mounttype == MOUNTTYPE_DISK && num < MAX_MOUNT_SLOTS)
     {
-        if (_mount_slots[num].host_slot == hostslot && _mount_slots[num].mode == mode && _mount_slots[num].path.compare(path) == 0)
+        if (_mount_slots[num].host_slot == hostslot && _mount_slots[num].mode == mode && _mount_slots[num].fetch == fetch && _mount_slots[num].path.compare(path) == 0)
             return;
         _dirty = true;
         _mount_slots[num].host_slot = hostslot;
         _mount_slots[num].mode = mode;
+        _mount_slots[num].fetch = fetch;
         _mount_slots[num].path = path;
 
         return;
@@ -80,6 +90,7 @@ void fnConfig::clear_mount(uint8_t num, mount_type_t mounttype)
         _mount_slots[num].path.clear();
         _mount_slots[num].host_slot = HOST_SLOT_INVALID;
         _mount_slots[num].mode = MOUNTMODE_INVALID;
+        _mount_slots[num].fetch = false;
         return;
     }
 
@@ -101,6 +112,7 @@ void fnConfig::_read_section_mount(std::stringstream &ss, int index)
     // Throw out any existing data for this index
     _mount_slots[index].host_slot = HOST_SLOT_INVALID;
     _mount_slots[index].mode = MOUNTMODE_INVALID;
+    _mount_slots[index].fetch = false;
     _mount_slots[index].path.clear();
 
     std::string line;
@@ -124,6 +136,10 @@ void fnConfig::_read_section_mount(std::stringstream &ss, int index)
                 _mount_slots[index].mode = mount_mode_from_string(value.c_str());
                 //Debug_printf("config mount %d mode=%d (\"%s\")\r\n", index, _mount_slots[index].mode, value.c_str());
             }
+            else if (strcasecmp(name.c_str(), "fetch") == 0)
+            {
+                _mount_slots[index].fetch = util_string_value_is_true(value);
+            }
             else if (strcasecmp(name.c_str(), "path") == 0)
             {
                 _mount_slots[index].path = value;
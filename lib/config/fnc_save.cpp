@@ -40,6 +40,10 @@ void fnConfig::save()
     ss << "status_wait_enabled=" << _general.status_wait_enabled << LINETERM;
     ss << "printer_enabled=" << _general.printer_enabled << LINETERM;
     ss << "encrypt_passphrase=" << _general.encrypt_passphrase << LINETERM;
+    if (_general.debug_levels.empty() == false)
+        ss << "debug_levels=" << _general.debug_levels << LINETERM;
+    ss << "write_behind=" << _general.write_behind << LINETERM;
+    ss << "read_ahead=" << _general.read_ahead << LINETERM;
 
     // ss << LINETERM;
 
@@ -48,6 +52,7 @@ void fnConfig::save()
     ss << "port=" << _serial.port << LINETERM;
     ss << "command=" << std::string(_serial_command_pin_names[_serial.command]) << LINETERM;
     ss << "proceed=" << std::string(_serial_proceed_pin_names[_serial.proceed]) << LINETERM;
+    ss << "precise_timing=" << _serial.precise_timing << LINETERM;
 
     // WIFI
     ss << LINETERM << "[WiFi]" LINETERM;
@@ -98,6 +103,8 @@ void fnConfig::save()
             ss << "hostslot=" << (_mount_slots[i].host_slot + 1) << LINETERM; // Write host slot as 1-based
             ss << "path=" << _mount_slots[i].path << LINETERM;
             ss << "mode=" << _mount_mode_names[_mount_slots[i].mode] << LINETERM;
+            if (_mount_slots[i].fetch)
+                ss << "fetch=1" << LINETERM;
         }
     }
 
@@ -175,6 +182,7 @@ void fnConfig::save()
     ss << "enabled=" << _boip.boip_enabled << LINETERM;
     ss << "host=" << _boip.host << LINETERM;
     ss << "port=" << _boip.port << LINETERM;
+    ss << "transport=" << (_boip.udp ? "udp" : "tcp") << LINETERM;
 
     // Write the results out
     FILE *fout = fopen(_general.config_file_path.c_str(), FILE_WRITE);
@@ -31,6 +31,15 @@ void fnConfig::store_serial_proceed(serial_proceed_pin proceed_pin)
     _dirty = true;
 }
 
+void fnConfig::store_serial_precise_timing(bool precise_timing)
+{
+    if (_serial.precise_timing == precise_timing)
+        return;
+
+    _serial.precise_timing = precise_timing;
+    _dirty = true;
+}
+
 void fnConfig::store_netsio_enabled(bool enabled) {
     if (_netsio.netsio_enabled == enabled)
         return;
@@ -79,6 +88,14 @@ void fnConfig::store_boip_port(int port) {
     _dirty = true;
 }
 
+void fnConfig::store_boip_udp(bool udp) {
+    if (_boip.udp == udp)
+        return;
+
+    _boip.udp = udp;
+    _dirty = true;
+}
+
 void fnConfig::_read_section_serial(std::stringstream &ss)
 {
     std::string line;
@@ -101,6 +118,10 @@ void fnConfig::_read_section_serial(std::stringstream &ss)
             {
                 _serial.proceed = serial_proceed_from_string(value.c_str());
             }
+            else if (strcasecmp(name.c_str(), "precise_timing") == 0)
+            {
+                _serial.precise_timing = util_string_value_is_true(value);
+            }
         }
     }
 }
@@ -159,6 +180,10 @@ void fnConfig::_read_section_boip(std::stringstream &ss)
                     port = CONFIG_DEFAULT_NETSIO_PORT;
                 _boip.port = port;
             }
+            else if (strcasecmp(name.c_str(), "transport") == 0)
+            {
+                _boip.udp = strcasecmp(value.c_str(), "udp") == 0;
+            }
         }
     }
 }
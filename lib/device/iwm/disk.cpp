@@ -6,6 +6,9 @@
 // #include "fnFsSD.h"
 #include "led.h"
 #include "fuji.h"
+#if SMARTPORT == SLIP
+#include "SmartPortCodes.h"
+#endif
 
 // #define LOCAL_TNFS
 
@@ -312,6 +315,11 @@ void iwmDisk::process(iwm_decoded_cmd_t cmd)
   case 0x00: // status
     Debug_printf("\r\nhandling status command");
     status_code = get_status_code(cmd); // (cmd.g7byte3 & 0x7f) | ((cmd.grp7msb << 3) & 0x00); // status codes 00-FF
+#if SMARTPORT == SLIP
+    if (status_code == SP_STATUS_SLIP_CAPS)
+      send_slip_caps_reply_packet();
+    else
+#endif
     if (disk_num == '0' && status_code > 0x05) // max regular status code is 0x05 to UniDisk
       theFuji.FujiStatus(cmd);
     else  
@@ -321,6 +329,12 @@ void iwmDisk::process(iwm_decoded_cmd_t cmd)
     Debug_printf("\r\nhandling read block command");
     iwm_readblock(cmd);
     break;
+#if SMARTPORT == SLIP
+  case SP_READ_BLOCKS: // read consecutive blocks, SLIP extension
+    Debug_printf("\r\nhandling read blocks command");
+    iwm_readblocks(cmd);
+    break;
+#endif
   case 0x02: // write block
     Debug_printf("\r\nhandling write block command");
     iwm_writeblock(cmd);
@@ -398,19 +412,96 @@ void iwmDisk::iwm_readblock(iwm_decoded_cmd_t cmd)
   switched = false; //if we made it here it's ok to reset switched
 
   sdstato = BLOCK_DATA_LEN;
-  if (_disk->read(block_num, &sdstato, data_buffer))
+  // mapped image is sent without copying
+  const uint8_t *block = _disk->block_ptr(block_num, BLOCK_DATA_LEN);
+  if (block == nullptr)
   {
-    Debug_printf("\r\nFile Seek or Read err: %d bytes", sdstato);
-    send_reply_packet(SP_ERR_IOERROR);
-    return; // todo - true or false?
+    if (_disk->read(block_num, &sdstato, data_buffer))
+    {
+      Debug_printf("\r\nFile Seek or Read err: %d bytes", sdstato);
+      send_reply_packet(SP_ERR_IOERROR);
+      return; // todo - true or false?
+    }
+    block = data_buffer;
   }
   
   // send_data_packet();
   Debug_printf("\r\nsending block packet ...");
-  if (IWM.iwm_send_packet(id(), iwm_packet_type_t::data, 0, data_buffer, BLOCK_DATA_LEN))
+  if (IWM.iwm_send_packet(id(), iwm_packet_type_t::data, 0, block, BLOCK_DATA_LEN))
    ((MediaTypePO*)_disk)->reset_seek_opto();  // force seek next time if send error
 }
 
+#if SMARTPORT == SLIP
+//*****************************************************************************
+// Function: send_slip_caps_reply_packet
+// Parameters: none
+// Returns: none
+//
+// Description: reply to status code SP_STATUS_SLIP_CAPS, tells the SLIP peer
+// which extensions are supported:
+// data byte 1 SLIP_CAP_* bits
+// data byte 2 max blocks per SP_READ_BLOCKS request
+//*****************************************************************************
+void iwmDisk::send_slip_caps_reply_packet()
+{
+  uint8_t data[2];
+  data[0] = SLIP_CAP_READ_BLOCKS;
+  data[1] = SLIP_READ_BLOCKS_MAX;
+  IWM.iwm_send_packet(id(), iwm_packet_type_t::status, SP_ERR_NOERROR, data, 2);
+}
+
+// Same checks as iwm_readblock, all blocks are returned in one response.
+// Sequential loads (ProDOS files) need one round trip per count blocks instead of one per block.
+void iwmDisk::iwm_readblocks(iwm_decoded_cmd_t cmd)
+{
+  uint32_t block_num = get_block_number(cmd);
+  uint8_t count = get_block_count(cmd);
+  Debug_printf("\r\nDrive %02x Read %u blocks from %06x\r\n", id(), count, block_num);
+
+  if (_disk == nullptr || !device_active)
+  {
+    Debug_printf("iwm_readblocks while device offline!\r\n");
+    send_reply_packet(SP_ERR_OFFLINE);
+    return;
+  }
+  if (switched && block_num > 2)
+  {
+    Debug_printf("iwm_readblocks() returning disk switched error\r\n");
+    send_reply_packet(SP_ERR_OFFLINE);
+    switched = false;
+    return;
+  }
+  if (count == 0 || count > SLIP_READ_BLOCKS_MAX || block_num + count > _disk->num_blocks)
+  {
+    send_reply_packet(SP_ERR_BADBLOCK);
+    return;
+  }
+  switched = false;
+
+  const uint8_t *blocks = _disk->block_ptr(block_num, count * BLOCK_DATA_LEN);
+  if (blocks != nullptr)
+  {
+    IWM.iwm_send_packet(id(), iwm_packet_type_t::data, 0, blocks, count * BLOCK_DATA_LEN);
+    return;
+  }
+
+  if (blocks_buffer.empty())
+    blocks_buffer.resize(SLIP_READ_BLOCKS_MAX * BLOCK_DATA_LEN);
+  for (uint8_t i = 0; i < count; i++)
+  {
+    uint16_t sdstato = BLOCK_DATA_LEN;
+    if (_disk->read(block_num + i, &sdstato, blocks_buffer.data() + i * BLOCK_DATA_LEN))
+    {
+      Debug_printf("\r\nFile Seek or Read err: %d bytes", sdstato);
+      send_reply_packet(SP_ERR_IOERROR);
+      return;
+    }
+  }
+
+  IWM.iwm_send_packet(id(), iwm_packet_type_t::data, 0, blocks_buffer.data(), count * BLOCK_DATA_LEN);
+}
+#endif
+
 void iwmDisk::iwm_writeblock(iwm_decoded_cmd_t cmd)
 {
   uint8_t status = 0;
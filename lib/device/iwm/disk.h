@@ -2,6 +2,8 @@
 #ifndef DISK_H
 #define DISK_H
 
+#include <vector>
+
 #include "bus.h"
 #include "../media/media.h"
 
@@ -28,6 +30,13 @@ protected:
     void iwm_readblock(iwm_decoded_cmd_t cmd) override;
     void iwm_writeblock(iwm_decoded_cmd_t cmd) override;
     uint32_t get_block_number(iwm_decoded_cmd_t cmd) {return cmd.params[2] + (cmd.params[3] << 8) + (cmd.params[4] << 16); };
+#if SMARTPORT == SLIP
+    // SLIP extensions, see SmartPortCodes.h
+    void send_slip_caps_reply_packet();
+    void iwm_readblocks(iwm_decoded_cmd_t cmd);
+    uint8_t get_block_count(iwm_decoded_cmd_t cmd) {return cmd.params[5]; };
+    std::vector<uint8_t> blocks_buffer; // SLIP_READ_BLOCKS_MAX blocks, allocated on first use
+#endif
 
     // void derive_percom_block(uint16_t numSectors);
     // void iwm_read_percom_block();
@@ -53,6 +62,7 @@ public:
     void set_disk_number(char c) { disk_num = c; }
     char get_disk_number() { return disk_num; };
     mediatype_t disktype() { return _disk == nullptr ? MEDIATYPE_UNKNOWN : _disk->_mediatype; };
+    void sync() { if (_disk != nullptr) _disk->sync(); };
     // void init();
     ~iwmDisk();
     // virtual void startup_hack();
@@ -8,6 +8,10 @@
 #include <cstring>
 #include <errno.h>
 #include <libgen.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 #include "compat_string.h"
 
 #include "../../../include/debug.h"
@@ -363,9 +367,9 @@ int sioFuji::sio_disk_image_mount(bool siomode, int slot)
 
     Debug_printf("Fuji cmd: MOUNT IMAGE 0x%02X 0x%02X\n", deviceSlot, options);
 
-    // TODO: Implement FETCH?
+    // DISK_ACCESS_MODE_FETCH may be combined with READ or WRITE
     char flag[4] = {'r', 'b', 0, 0};
-    if (options == DISK_ACCESS_MODE_WRITE)
+    if (options & DISK_ACCESS_MODE_WRITE)
         flag[2] = '+';
 
     // Make sure we weren't given a bad hostSlot
@@ -400,9 +404,16 @@ int sioFuji::sio_disk_image_mount(bool siomode, int slot)
     boot_config = false;
     status_wait_count = 0;
 
+    // Journal left by crash may change the image, apply it first
+    disk.fileh = host.filehandler_write_behind(disk.filename, disk.fileh, options & DISK_ACCESS_MODE_WRITE);
+
     // We need the file size for loading XEX files and for CASSETTE, so get that too
     disk.disk_size = host.file_size(disk.fileh);
 
+    // Copy image to RAM, writes go back to host only if mounted for writing
+    if (options & DISK_ACCESS_MODE_FETCH)
+        disk.fileh = host.filehandler_fetch(disk.filename, disk.fileh, disk.disk_size, options & DISK_ACCESS_MODE_WRITE);
+
     // And now mount it
     disk.disk_type = disk.disk_dev.mount(disk.fileh, disk.filename, disk.disk_size);
 
@@ -562,60 +573,140 @@ void sioFuji::sio_copy_file()
 }
 
 // Mount all
-int sioFuji::mount_all(bool siomode)
+int sioFuji::_mount_host_disks(uint8_t host_slot)
 {
-    bool nodisks = true; // Check at the end if no disks are in a slot and disable config
+    fujiHost &host = _fnHosts[host_slot];
+    int errors = 0;
 
-    for (int i = 0; i < 8; i++)
+    // slots of one host are mounted in order, host file system is not shared between threads
+    bool host_ok = host.mount();
+    if (!host_ok)
+        Debug_printf("mount_all: host #%u \"%s\" failed to mount\n", host_slot, host.get_hostname());
+
+    for (int i = 0; i < MAX_DISK_DEVICES; i++)
     {
         fujiDisk &disk = _fnDisks[i];
-        fujiHost &host = _fnHosts[disk.host_slot];
-        char flag[4] = {'r', 'b', 0, 0};
+        if (disk.host_slot != host_slot)
+            continue;
 
-        if (disk.access_mode == DISK_ACCESS_MODE_WRITE)
-            flag[2] = '+';
-
-        if (disk.host_slot != INVALID_HOST_SLOT)
+        if (!host_ok)
         {
-            nodisks = false; // We have a disk in a slot
+            _mount_status[i] = MOUNT_STATUS_HOST_FAILED;
+            errors++;
+            continue;
+        }
 
-            if (host.mount() == false)
-            {
-                return _on_error(siomode);
-            }
+        char flag[4] = {'r', 'b', 0, 0};
+        if (disk.access_mode & DISK_ACCESS_MODE_WRITE)
+            flag[2] = '+';
 
-            Debug_printf("Selecting '%s' from host #%u as %s on D%u:\n",
-                         disk.filename, disk.host_slot, flag, i + 1);
+        Debug_printf("Selecting '%s' from host #%u as %s on D%u:\n",
+                     disk.filename, disk.host_slot, flag, i + 1);
 
-            disk.fileh = host.filehandler_open(disk.filename, disk.filename, sizeof(disk.filename), flag);
+        disk.fileh = host.filehandler_open(disk.filename, disk.filename, sizeof(disk.filename), flag);
 
-            if (disk.fileh == nullptr)
-            {
-                return _on_error(siomode);
-            }
+        if (disk.fileh == nullptr)
+        {
+            Debug_printf("mount_all: D%u: can't open '%s'\n", i + 1, disk.filename);
+            _mount_status[i] = MOUNT_STATUS_OPEN_FAILED;
+            errors++;
+            continue;
+        }
+
+        // Journal left by crash may change the image, apply it first
+        disk.fileh = host.filehandler_write_behind(disk.filename, disk.fileh, disk.access_mode & DISK_ACCESS_MODE_WRITE);
 
-            // We've gotten this far, so make sure our bootable CONFIG disk is disabled
-            boot_config = false;
-            status_wait_count = 0;
+        // We need the file size for loading XEX files and for CASSETTE, so get that too
+        disk.disk_size = host.file_size(disk.fileh);
 
-            // We need the file size for loading XEX files and for CASSETTE, so get that too
-            disk.disk_size = host.file_size(disk.fileh);
+        // Copy image to RAM, writes go back to host only if mounted for writing
+        if (disk.access_mode & DISK_ACCESS_MODE_FETCH)
+            disk.fileh = host.filehandler_fetch(disk.filename, disk.fileh, disk.disk_size, disk.access_mode & DISK_ACCESS_MODE_WRITE);
 
-            // Set the host slot for high score mode
-            // TODO: Refactor along with mount disk image.
-            disk.disk_dev.host = &host;
+        // Set the host slot for high score mode
+        // TODO: Refactor along with mount disk image.
+        disk.disk_dev.host = &host;
 
-            // And now mount it
-            disk.disk_type = disk.disk_dev.mount(disk.fileh, disk.filename, disk.disk_size);
+        // And now mount it
+        disk.disk_type = disk.disk_dev.mount(disk.fileh, disk.filename, disk.disk_size);
+        if (disk.disk_type == MEDIATYPE_UNKNOWN)
+        {
+            // media type did not take the file, close it here
+            Debug_printf("mount_all: D%u: '%s' not recognized\n", i + 1, disk.filename);
+            disk.disk_dev.unmount();
+            disk.fileh->close();
+            disk.fileh = nullptr;
+            _mount_status[i] = MOUNT_STATUS_MEDIA_FAILED;
+            errors++;
+            continue;
         }
+        _mount_status[i] = MOUNT_STATUS_OK;
+    }
+    return errors;
+}
+
+// Mount all
+// Hosts are mounted concurrently, a slow or unreachable host does not delay the others
+int sioFuji::mount_all(bool siomode)
+{
+    std::vector<uint8_t> hosts;
+
+    // every host once, even if used by several slots
+    for (int i = 0; i < MAX_DISK_DEVICES; i++)
+    {
+        _mount_status[i] = MOUNT_STATUS_NONE;
+        uint8_t hs = _fnDisks[i].host_slot;
+        if (hs != INVALID_HOST_SLOT && std::find(hosts.begin(), hosts.end(), hs) == hosts.end())
+            hosts.push_back(hs);
     }
 
-    if (nodisks)
+    if (hosts.empty())
     {
         // No disks in a slot, disable config
         boot_config = false;
+        return _on_ok(siomode);
     }
 
+    std::atomic<size_t> next{0};
+    std::atomic<int> errors{0};
+    auto worker = [&]() {
+        size_t h;
+        while ((h = next++) < hosts.size())
+            errors += _mount_host_disks(hosts[h]);
+    };
+
+    uint64_t start = fnSystem.millis();
+    std::vector<std::thread> workers;
+    for (size_t w = 1; w < hosts.size() && w < MOUNT_ALL_WORKERS; w++)
+        workers.emplace_back(worker);
+    worker();
+    for (auto &t : workers)
+        t.join();
+
+    Debug_printf("mount_all: %u host(s) in %llu ms, %d slot(s) failed\n",
+                 (unsigned)hosts.size(), (unsigned long long)(fnSystem.millis() - start), errors.load());
+
+    int mounted = 0;
+    for (int i = 0; i < MAX_DISK_DEVICES; i++)
+    {
+        if (_fnDisks[i].host_slot == INVALID_HOST_SLOT)
+            continue;
+        if (_mount_status[i] != MOUNT_STATUS_OK)
+            Debug_printf("mount_all: D%u: '%s' not mounted, status %d\n", i + 1, _fnDisks[i].filename, _mount_status[i]);
+        else
+            mounted++;
+    }
+
+    if (mounted > 0)
+    {
+        // We've gotten this far, so make sure our bootable CONFIG disk is disabled
+        boot_config = false;
+        status_wait_count = 0;
+    }
+
+    if (errors > 0)
+        return _on_error(siomode);
+
     return _on_ok(siomode);
 }
 
@@ -1703,6 +1794,8 @@ void sioFuji::_populate_slots_from_config()
                     _fnDisks[i].access_mode = DISK_ACCESS_MODE_WRITE;
                 else
                     _fnDisks[i].access_mode = DISK_ACCESS_MODE_READ;
+                if (Config.get_mount_fetch(i))
+                    _fnDisks[i].access_mode |= DISK_ACCESS_MODE_FETCH;
             }
         }
     }
@@ -1733,7 +1826,8 @@ void sioFuji::_populate_config_from_slots()
             Config.clear_mount(i);
         else
             Config.store_mount(i, _fnDisks[i].host_slot, _fnDisks[i].filename,
-                               _fnDisks[i].access_mode == DISK_ACCESS_MODE_WRITE ? fnConfig::mount_modes::MOUNTMODE_WRITE : fnConfig::mount_modes::MOUNTMODE_READ);
+                               _fnDisks[i].access_mode & DISK_ACCESS_MODE_WRITE ? fnConfig::mount_modes::MOUNTMODE_WRITE : fnConfig::mount_modes::MOUNTMODE_READ,
+                               fnConfig::mount_types::MOUNTTYPE_DISK, _fnDisks[i].access_mode & DISK_ACCESS_MODE_FETCH);
     }
 }
 
@@ -1773,8 +1867,14 @@ void sioFuji::sio_set_device_filename()
     // AUX1 is the desired device slot
     uint8_t slot = cmdFrame.aux1;
     // AUX2 contains the host slot and the mount mode (READ/WRITE)
+    // Host slots fit in bits 4-6, bit 7 is DISK_ACCESS_MODE_FETCH (host 0xF means none)
     uint8_t host = cmdFrame.aux2 >> 4;
     uint8_t mode = cmdFrame.aux2 & 0x0F;
+    if (host != 0x0F && (cmdFrame.aux2 & DISK_ACCESS_MODE_FETCH))
+    {
+        host &= 0x07;
+        mode |= DISK_ACCESS_MODE_FETCH;
+    }
 
     uint8_t ck = bus_to_peripheral((uint8_t *)tmp, MAX_FILENAME_LEN);
 
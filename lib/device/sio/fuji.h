@@ -22,6 +22,8 @@
 #define MAX_DISK_DEVICES 8
 #define MAX_NETWORK_DEVICES 8
 
+#define MOUNT_ALL_WORKERS 4 // hosts mounted concurrently by mount_all
+
 #define MAX_SSID_LEN 32
 #define MAX_WIFI_PASS_LEN 64
 
@@ -30,6 +32,16 @@
 #define READ_DEVICE_SLOTS_DISKS1 0x00
 #define READ_DEVICE_SLOTS_TAPE 0x10
 
+// Result of last mount_all for a disk slot
+enum mount_status_t
+{
+    MOUNT_STATUS_NONE = 0,      // slot empty or not mounted by mount_all
+    MOUNT_STATUS_OK,
+    MOUNT_STATUS_HOST_FAILED,   // host could not be mounted
+    MOUNT_STATUS_OPEN_FAILED,   // image could not be opened
+    MOUNT_STATUS_MEDIA_FAILED   // image opened but not recognized
+};
+
 typedef struct
 {
     char ssid[MAX_SSID_LEN+1]; // SSID + 0x0 terminator
@@ -100,6 +112,11 @@ private:
     int _on_ok(bool siomode);
     int _on_error(bool siomode, int rc=-1);
 
+    mount_status_t _mount_status[MAX_DISK_DEVICES] = { MOUNT_STATUS_NONE };
+
+    // Mounts host and then every disk slot using it, returns number of failed slots
+    int _mount_host_disks(uint8_t host_slot);
+
     appkey _current_appkey;
 
     std::string base64_buffer;
@@ -201,6 +218,7 @@ public:
     void _populate_config_from_slots();
 
     int mount_all(bool siomode=true);              // 0xD7
+    mount_status_t get_mount_status(int drive_slot) { return _mount_status[drive_slot]; };
 
     sioFuji();
 };
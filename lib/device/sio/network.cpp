@@ -940,6 +940,11 @@ void sioNetwork::sio_poll_interrupt()
     }
 }
 
+bool sioNetwork::sio_poll_needed()
+{
+    return protocol != nullptr && protocol->interruptEnable;
+}
+
 /** PRIVATE METHODS ************************************************************/
 
 /**
@@ -127,6 +127,11 @@ public:
      */
     void sio_poll_interrupt();
 
+    /**
+     * Is sio_poll_interrupt() needed to be called periodically?
+     */
+    bool sio_poll_needed();
+
     /**
      * Process incoming SIO command for device 0x7X
      * @param comanddata incoming 4 bytes containing command and aux bytes
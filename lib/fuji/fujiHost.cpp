@@ -9,6 +9,9 @@
 #include "fnFsTNFS.h"
 #include "fnFsSMB.h"
 #include "fnFsFTP.h"
+#include "fnFileWriteBehind.h"
+#include "fnFileFetch.h"
+#include "fnConfig.h"
 
 #include "utils.h"
 
@@ -242,6 +245,77 @@ FileHandler * fujiHost::filehandler_open(const char *path, char *fullpath, int f
     return _fs->filehandler_open(fullpath, mode);
 }
 
+// Name of file on SD which belongs to fullpath on this host
+void fujiHost::_sd_path_for(const char *prefix, const char *fullpath, char *buffer, size_t buffersize)
+{
+    uint64_t id = util_hash64(fullpath, strlen(fullpath));
+    id = util_hash64(_hostname, strlen(_hostname), id);
+    snprintf(buffer, buffersize, "%s-%016llx", prefix, (unsigned long long)id);
+}
+
+/* Writes to remote disk images return once they are journaled on SD,
+   the journal is replayed if the same image is opened again after a crash.
+   Journal left by crash is applied on any mount of the image, write or not.
+   Returns fh unchanged if write-behind is not used.
+*/
+FileHandler * fujiHost::filehandler_write_behind(const char *fullpath, FileHandler *fh, bool write)
+{
+    if (fh == nullptr || !fnSDFAT.running())
+        return fh;
+    if (_type != HOSTTYPE_TNFS && _type != HOSTTYPE_SMB)
+        return fh;
+
+    // one journal per image
+    char path[40];
+    _sd_path_for("/.writebehind", fullpath, path, sizeof(path));
+
+    // image is mounted for writing in other slot, its pending writes are not ours
+    if (FileHandlerWriteBehind::journal_in_use(path))
+    {
+        Debug_printf("fujiHost #%d \"%s\" has write-behind in other slot\n", slotid, fullpath);
+        return fh;
+    }
+
+    if (write && Config.get_general_write_behind())
+    {
+        Debug_printf("fujiHost #%d write-behind for \"%s\"\n", slotid, fullpath);
+        return new FileHandlerWriteBehind(fh, &fnSDFAT, path);
+    }
+
+    if (fnSDFAT.exists(path))
+    {
+        // read only mount needs other handle to write the image
+        FileHandler *wfh = write ? fh : _fs->filehandler_open(fullpath, "rb+");
+        if (wfh == nullptr)
+        {
+            Debug_printf("fujiHost #%d can't apply journal to \"%s\"\n", slotid, fullpath);
+            return fh;
+        }
+        FileHandlerWriteBehind::journal_apply(wfh, &fnSDFAT, path);
+        if (wfh != fh)
+            wfh->close();
+    }
+    return fh;
+}
+
+/* Image is copied to RAM in background, reads of the rest are fetched on demand.
+   Copy of images larger than FETCH_MEM_MAXSIZE is kept on SD.
+   With write_back writes go to the image too, otherwise only to the copy.
+*/
+FileHandler * fujiHost::filehandler_fetch(const char *fullpath, FileHandler *fh, long size, bool write_back)
+{
+    if (fh == nullptr || size < 0)
+        return fh;
+
+    Debug_printf("fujiHost #%d fetching \"%s\"\n", slotid, fullpath);
+    if (size <= FETCH_MEM_MAXSIZE || !fnSDFAT.running())
+        return new FileHandlerFetch(fh, size, write_back);
+
+    char path[40];
+    _sd_path_for("/.fetch", fullpath, path, sizeof(path));
+    return new FileHandlerFetch(fh, size, write_back, &fnSDFAT, path);
+}
+
 /* Remove a file from the host
  * Returns true on error, false on success
 */
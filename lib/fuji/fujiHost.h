@@ -35,6 +35,8 @@ private:
     int unmount_local();
     int unmount_tnfs();
 
+    void _sd_path_for(const char *prefix, const char *fullpath, char *buffer, size_t buffersize);
+
 public:
     int slotid = -1;
 
@@ -59,6 +61,11 @@ public:
     // File functions
     bool file_exists(const char *path);
     FileHandler * filehandler_open(const char *path, char *fullpath, int fullpathlen, const char *mode);
+    // Wraps opened file into write-behind layer if enabled, write and host is remote
+    // Applies journal left by crash otherwise
+    FileHandler * filehandler_write_behind(const char *fullpath, FileHandler *fh, bool write);
+    // Wraps opened file into layer which copies it to RAM (DISK_ACCESS_MODE_FETCH)
+    FileHandler * filehandler_fetch(const char *fullpath, FileHandler *fh, long size, bool write_back);
     long file_size(FileHandler *filehandle);
     bool file_remove(char *fullpath);
 
@@ -0,0 +1,234 @@
+#include "fnEventLoop.h"
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
+
+#include "fnSystem.h"
+#include "../../include/debug.h"
+
+#define EVENT_LOOP_MAX_EVENTS 16
+
+EventLoop fnEventLoop;
+
+#if defined(__linux__)
+
+void EventLoop::begin()
+{
+    if (_initialized)
+        return;
+
+    _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    _wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    _timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (_epoll_fd < 0 || _wake_fd < 0 || _timer_fd < 0)
+    {
+        Debug_printf("EventLoop::begin failed, error %d: %s\n", errno, strerror(errno));
+        end();
+        return;
+    }
+    _initialized = true;
+    add_fd(_wake_fd);
+    add_fd(_timer_fd);
+    Debug_println("EventLoop started");
+}
+
+void EventLoop::end()
+{
+    _initialized = false;
+    if (_timer_fd >= 0)
+        close(_timer_fd);
+    if (_wake_fd >= 0)
+        close(_wake_fd);
+    if (_epoll_fd >= 0)
+        close(_epoll_fd);
+    _timer_fd = _wake_fd = _epoll_fd = -1;
+}
+
+bool EventLoop::add_fd(int fd, bool write)
+{
+    if (!_initialized || fd < 0)
+        return false;
+
+    struct epoll_event ev;
+    ev.events = write ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+    {
+        Debug_printf("EventLoop::add_fd(%d) error %d: %s\n", fd, errno, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+bool EventLoop::modify_fd(int fd, bool write)
+{
+    if (!_initialized || fd < 0)
+        return false;
+
+    struct epoll_event ev;
+    ev.events = write ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+void EventLoop::remove_fd(int fd)
+{
+    if (!_initialized || fd < 0)
+        return;
+    // fd may be closed already, it is removed from epoll set automatically then
+    epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void EventLoop::wake()
+{
+    uint64_t expected = 0;
+    if (!_wake_time.compare_exchange_strong(expected, fnSystem.micros()))
+        return; // already woken
+    if (_initialized)
+    {
+        uint64_t one = 1;
+        if (::write(_wake_fd, &one, sizeof(one)) < 0)
+            Debug_printf("EventLoop::wake error %d: %s\n", errno, strerror(errno));
+    }
+}
+
+int EventLoop::wait(uint32_t max_ms)
+{
+    if (!_initialized)
+    {
+        // no event loop, keep old behavior of not sleeping at all
+        _deadline = 0;
+        return 0;
+    }
+
+    int timeout_ms = max_ms;
+    if (_deadline != 0)
+    {
+        uint64_t now = fnSystem.micros();
+        if (_deadline <= now)
+            timeout_ms = 0;
+        else if (_deadline - now < (uint64_t)max_ms * 1000)
+        {
+            // arm timer for sub-millisecond deadline precision
+            uint64_t ns = (_deadline - now) * 1000;
+            struct itimerspec its;
+            memset(&its, 0, sizeof(its));
+            its.it_value.tv_sec = ns / 1000000000;
+            its.it_value.tv_nsec = ns % 1000000000;
+            timerfd_settime(_timer_fd, 0, &its, nullptr);
+        }
+        _deadline = 0;
+    }
+    // pending wake(), don't sleep
+    if (_wake_time != 0)
+        timeout_ms = 0;
+
+    struct epoll_event events[EVENT_LOOP_MAX_EVENTS];
+    int n = epoll_wait(_epoll_fd, events, EVENT_LOOP_MAX_EVENTS, timeout_ms);
+    if (n < 0)
+    {
+        if (errno != EINTR)
+            Debug_printf("EventLoop::wait error %d: %s\n", errno, strerror(errno));
+        return 0;
+    }
+
+    uint64_t value;
+    for (int i = 0; i < n; i++)
+    {
+        // clear eventfd/timerfd, other fds are handled by their owners
+        int fd = events[i].data.fd;
+        if ((fd == _wake_fd || fd == _timer_fd) && read(fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+            Debug_printf("EventLoop::wait read error %d: %s\n", errno, strerror(errno));
+    }
+
+    uint64_t t = _wake_time.exchange(0);
+    if (t != 0)
+    {
+        uint64_t now = fnSystem.micros();
+        _wake_latency.record(now > t ? now - t : 0);
+    }
+    return n;
+}
+
+#else
+// no epoll, sleep on condition variable
+
+void EventLoop::begin()
+{
+    _initialized = true;
+}
+
+void EventLoop::end()
+{
+    _initialized = false;
+}
+
+bool EventLoop::add_fd(int fd, bool write)
+{
+    return false;
+}
+
+bool EventLoop::modify_fd(int fd, bool write)
+{
+    return false;
+}
+
+void EventLoop::remove_fd(int fd)
+{
+}
+
+void EventLoop::wake()
+{
+    uint64_t expected = 0;
+    if (!_wake_time.compare_exchange_strong(expected, fnSystem.micros()))
+        return; // already woken
+    std::lock_guard<std::mutex> lock(_mutex);
+    _woken = true;
+    _cv.notify_one();
+}
+
+int EventLoop::wait(uint32_t max_ms)
+{
+    // file descriptors are not watched, don't sleep longer than 1 ms
+    uint32_t timeout_us = _initialized ? 1000 : 0;
+    if (_deadline != 0)
+    {
+        uint64_t now = fnSystem.micros();
+        if (_deadline <= now)
+            timeout_us = 0;
+        else if (_deadline - now < timeout_us)
+            timeout_us = _deadline - now;
+        _deadline = 0;
+    }
+    if (max_ms == 0)
+        timeout_us = 0;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    bool woken = _cv.wait_for(lock, std::chrono::microseconds(timeout_us), [this]{ return _woken; });
+    _woken = false;
+    lock.unlock();
+
+    uint64_t t = _wake_time.exchange(0);
+    if (t != 0)
+    {
+        uint64_t now = fnSystem.micros();
+        _wake_latency.record(now > t ? now - t : 0);
+    }
+    return woken ? 1 : 0;
+}
+
+#endif // __linux__
+
+void EventLoop::schedule(uint32_t ms)
+{
+    uint64_t t = fnSystem.micros() + (uint64_t)ms * 1000;
+    if (_deadline == 0 || t < _deadline)
+        _deadline = t;
+}
@@ -0,0 +1,61 @@
+/*
+    FujiNet Event Loop
+    Lets the main service loop sleep until there is some work to do:
+    a watched file descriptor becomes ready, another thread calls wake()
+    or a scheduled deadline expires.
+*/
+#ifndef FNEVENTLOOP_H
+#define FNEVENTLOOP_H
+
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+#include "histogram.h"
+
+// longest sleep of the service loop, bounds the latency of work which is not event driven
+#define EVENT_LOOP_MAX_IDLE_MS 100
+
+class EventLoop
+{
+private:
+    bool _initialized = false;
+#if defined(__linux__)
+    int _epoll_fd = -1;
+    int _wake_fd = -1;  // eventfd signaled by wake()
+    int _timer_fd = -1; // timerfd for scheduled deadline
+#else
+    // no epoll, wake() and deadlines only
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _woken = false;
+#endif
+    uint64_t _deadline = 0; // fnSystem.micros() of earliest scheduled wake up, 0 = none
+    std::atomic<uint64_t> _wake_time{0}; // time of first wake() since last wait()
+
+    Histogram _wake_latency; // wake() .. wait() return
+
+public:
+    void begin();
+    void end();
+
+    // wake up wait() when fd becomes readable (or writable if write is set)
+    bool add_fd(int fd, bool write = false);
+    bool modify_fd(int fd, bool write);
+    void remove_fd(int fd);
+
+    // wake up wait(), can be called from any thread
+    void wake();
+    // make next wait() return no later than ms from now, service loop thread only
+    void schedule(uint32_t ms);
+
+    // sleep until any event or max_ms, returns number of events
+    int wait(uint32_t max_ms);
+
+    const Histogram &wake_latency() { return _wake_latency; }
+};
+
+extern EventLoop fnEventLoop;
+
+#endif // FNEVENTLOOP_H
@@ -21,6 +21,7 @@
 // #include <soc/rtc.h>
 // #include <esp_adc_cal.h>
 #include <time.h>
+#include <errno.h>
 #include <cstring>
 #include <sys/time.h>
 #include <unistd.h>
@@ -28,6 +29,8 @@
 #include "compat_uname.h"
 #include "compat_gettimeofday.h"
 
+#include "histogram.h"
+
 #include "../../include/debug.h"
 #include "../../include/version.h"
 #include "../../include/pinmap.h"
@@ -330,6 +333,12 @@ void SystemManager::delay_microseconds(uint32_t us)
 #else
 void SystemManager::delay_microseconds(uint32_t us)
 {
+    if (_delay_mode == DELAY_MODE_PRECISE)
+    {
+        _delay_precise(us);
+        return;
+    }
+
     // a)
     // struct timespec ts;
     // ts.tv_sec = us / (1000 * 1000);
@@ -342,7 +351,88 @@ void SystemManager::delay_microseconds(uint32_t us)
     // c)
     // std::this_thread::sleep_for(std::chrono::microseconds(us));
 }
+
+static uint64_t _monotonic_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Sleep for the largest part of the delay and busy-loop for the rest.
+// The busy-loop part covers scheduler wake-up latency measured by calibrate_delay()
+void SystemManager::_delay_precise(uint32_t us)
+{
+    uint64_t deadline = _monotonic_ns() + (uint64_t)us * 1000;
+    uint64_t spin_ns = (uint64_t)_delay_spin_us * 1000;
+
+    if (us > _delay_spin_us)
+    {
+        uint64_t wake = deadline - spin_ns;
+        struct timespec ts;
+#if defined(__linux__)
+        // absolute deadline, not prolonged by interrupted sleep
+        ts.tv_sec = wake / 1000000000ULL;
+        ts.tv_nsec = wake % 1000000000ULL;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+            ;
+#else
+        uint64_t now;
+        while ((now = _monotonic_ns()) < wake)
+        {
+            ts.tv_sec = (wake - now) / 1000000000ULL;
+            ts.tv_nsec = (wake - now) % 1000000000ULL;
+            nanosleep(&ts, NULL);
+        }
 #endif
+    }
+
+    while (_monotonic_ns() < deadline)
+        NOP();
+}
+#endif
+
+/* Measure how late the process wakes up from short sleeps
+   and use it as busy-wait part of precise delay
+*/
+uint32_t SystemManager::calibrate_delay()
+{
+#if defined(_WIN32)
+    // Windows delay_microseconds() is always sleep + busy-loop
+    return 0;
+#else
+    const int rounds = 100;
+    const uint32_t sleep_us = 100;
+    Histogram late;
+
+    for (int i = 0; i < rounds; i++)
+    {
+        uint64_t start = _monotonic_ns();
+        usleep(sleep_us);
+        uint64_t elapsed_us = (_monotonic_ns() - start) / 1000;
+        late.record(elapsed_us > sleep_us ? elapsed_us - sleep_us : 0);
+    }
+
+    // cover 99% of wake-ups, the rest is handled by sleep alone
+    uint32_t spin = (uint32_t)late.percentile(99.0) + 10;
+    if (spin > 500)
+        spin = 500;
+    _delay_spin_us = spin;
+
+    Debug_printf("Delay calibration: wake-up latency p50 %llu us, p99 %llu us, max %llu us, spin %u us\n",
+        (unsigned long long)late.percentile(50.0), (unsigned long long)late.percentile(99.0),
+        (unsigned long long)late.max(), _delay_spin_us);
+    return _delay_spin_us;
+#endif
+}
+
+void SystemManager::set_delay_mode(delay_modes mode)
+{
+    if (mode == DELAY_MODE_PRECISE && _delay_spin_us == 0)
+        calibrate_delay();
+    _delay_mode = mode;
+    Debug_printf("Delay mode: %s\n", mode == DELAY_MODE_PRECISE ? "precise" : "sleep");
+}
 
 // from esp32-hal-misc.
 void SystemManager::yield()
@@ -36,6 +36,10 @@ private:
     char _uname_string[128];
     uint64_t _reboot_at = 0;
     int _reboot_code = EXIT_AND_RESTART;
+    int _delay_mode = 0; // DELAY_MODE_SLEEP
+    uint32_t _delay_spin_us = 0; // busy-wait part of precise delay
+
+    void _delay_precise(uint32_t us);
 
 public:
     SystemManager();
@@ -83,6 +87,13 @@ public:
         CHIP_ESP32
     };
 
+    // delay_microseconds() implementation
+    enum delay_modes
+    {
+        DELAY_MODE_SLEEP = 0,   // plain sleep, may overshoot by scheduler latency
+        DELAY_MODE_PRECISE      // sleep until calibrated time before deadline, then spin
+    };
+
     enum pull_updown_t
     {
         PULL_NONE = 0,
@@ -112,6 +123,9 @@ public:
     uint64_t micros();
     void delay_microseconds(uint32_t us);
     void delay(uint32_t ms);
+    void set_delay_mode(delay_modes mode);
+    delay_modes get_delay_mode() { return (delay_modes)_delay_mode; };
+    uint32_t calibrate_delay();
 
     const char *get_uptime_str();
     const char *get_current_time_str();
@@ -20,12 +20,17 @@
 
 #if defined(__linux__)
 #include <linux/serial.h>
+#include <poll.h>
+#include <signal.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
 #include "linux_termios2.h"
 #elif defined(__APPLE__)
 #include <IOKit/serial/ioss.h>
 #endif
 
 #include "fnSystem.h"
+#include "fnEventLoop.h"
 #include "fnUART.h"
 #include "../../include/debug.h"
 
@@ -73,6 +78,9 @@ void UARTManager::end()
         Debug_printf("### UART stopped ###\n");
     }
 #else
+#if defined(__linux__)
+    _stop_io_threads();
+#endif
     if (_fd >= 0)
     {
         close(_fd);
@@ -86,11 +94,25 @@ void UARTManager::end()
 
 bool UARTManager::poll(int ms)
 {
+#if defined(__linux__)
+    // wait for data or COMMAND line change reported by serial I/O threads
+    if (_initialized && _rx_thread.joinable())
+        return _wait_event(ms, true);
+#endif
     // TODO check serial port command link and input data
     fnSystem.delay_microseconds(500); // TODO use ms parameter
     return false;
 }
 
+uint64_t UARTManager::command_time()
+{
+#if defined(__linux__)
+    if (_line_watch)
+        return _command_time;
+#endif
+    return 0;
+}
+
 #if defined(_WIN32)
 // Windows UART code
 
@@ -584,17 +606,16 @@ void UARTManager::begin(int baud)
 	}
 
 #if defined(__linux__)
-    // Enable low latency
+    // Enable low latency, not supported by pseudo terminals
 	struct serial_struct ss;
     if (-1 == ioctl(_fd, TIOCGSERIAL, &ss))
-    {
         Debug_printf("TIOCGSERIAL error %d: %s\n", errno, strerror(errno));
-        suspend();
-        return;
+    else
+    {
+        ss.flags |= ASYNC_LOW_LATENCY;
+        if (-1 == ioctl(_fd, TIOCSSERIAL, &ss))
+            Debug_printf("TIOCSSERIAL error %d: %s\n", errno, strerror(errno));
     }
-	ss.flags |= ASYNC_LOW_LATENCY;
-    if (-1 == ioctl(_fd, TIOCSSERIAL, &ss))
-        Debug_printf("TIOCSSERIAL error %d: %s\n", errno, strerror(errno));
 #endif
 
 #ifdef BUILD_ADAM
@@ -646,6 +667,9 @@ void UARTManager::begin(int baud)
     // Set initialized.
     _initialized = true;
     set_baudrate(baud);
+#if defined(__linux__)
+    _start_io_threads();
+#endif
 }
 
 
@@ -663,7 +687,12 @@ void UARTManager::suspend(int sec)
 void UARTManager::flush_input()
 {
     if (_initialized)
+    {
         tcflush(_fd, TCIFLUSH);
+#if defined(__linux__)
+        _rx_ring.discard();
+#endif
+    }
 }
 
 /* Clears input buffer and flushes out transmit buffer waiting at most
@@ -682,6 +711,10 @@ int UARTManager::available()
     int result;
     if (!_initialized)
         return 0;
+#if defined(__linux__)
+    if (_rx_thread.joinable())
+        return _rx_ring.available();
+#endif
 	if (ioctl(_fd, FIONREAD, &result) < 0)
         return 0;
     return result;
@@ -803,6 +836,22 @@ bool UARTManager::command_asserted(void)
             return false;
     }
 
+#if defined(__linux__)
+    if (_io_error)
+    {
+        Debug_println("UART serial I/O thread failed");
+        suspend();
+        return false;
+    }
+    if (_line_watch)
+    {
+        // COMMAND state from line thread, short assert pulse is reported once
+        if (_command_edge.exchange(false))
+            return true;
+        return _command_state;
+    }
+#endif
+
     if (ioctl(_fd, TIOCMGET, &status) < 0)
     {
         // handle serial port errors
@@ -848,6 +897,10 @@ timeval timeval_from_ms(const uint32_t millis)
 
 bool UARTManager::waitReadable(uint32_t timeout_ms)
 {
+#if defined(__linux__)
+    if (_rx_thread.joinable())
+        return _wait_event(timeout_ms, false);
+#endif
     // Setup a select call to block for serial data or a timeout
     fd_set readfds;
     FD_ZERO(&readfds);
@@ -898,6 +951,11 @@ size_t UARTManager::readBytes(uint8_t *buffer, size_t length, bool command_mode)
     int rxbytes;
     for (rxbytes=0; rxbytes<length;)
     {
+#if defined(__linux__)
+        if (_rx_thread.joinable())
+            result = _rx_ring.get(&buffer[rxbytes], length-rxbytes);
+        else
+#endif
         result = ::read(_fd, &buffer[rxbytes], length-rxbytes);
         // Debug_printf("read: %d\n", result);
         if (result < 0)
@@ -1017,6 +1075,236 @@ size_t UARTManager::write(const uint8_t *buffer, size_t size)
     return txbytes;
 }
 
+#if defined(__linux__)
+// Serial I/O threads
+
+static void _uart_wake_handler(int sig)
+{
+    // nothing to do, signal just interrupts TIOCMIWAIT
+}
+
+void UARTManager::_start_io_threads()
+{
+    _io_stop = false;
+    _io_error = false;
+    _line_done = false;
+    _line_watch = false;
+    _command_edge = false;
+    _command_time = 0;
+    _rx_ring.discard();
+    _poll_events = _io_events;
+    _rx_overruns = 0;
+
+    _wake_fd = eventfd(0, EFD_NONBLOCK);
+    if (_wake_fd < 0)
+    {
+        Debug_printf("UART eventfd error %d: %s\n", errno, strerror(errno));
+        return;
+    }
+    _rx_thread = std::thread(&UARTManager::_rx_thread_loop, this);
+
+    if (_command_tiocm != 0)
+    {
+        // handler without SA_RESTART to interrupt TIOCMIWAIT on end()
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = _uart_wake_handler;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGUSR2, &sa, nullptr);
+
+        int status;
+        if (ioctl(_fd, TIOCMGET, &status) == 0)
+        {
+            _command_state = (status & _command_tiocm) != 0;
+            _line_watch = true;
+            _line_thread = std::thread(&UARTManager::_line_thread_loop, this);
+        }
+    }
+    Debug_printf("UART serial I/O threads started%s\n", _line_watch ? ", watching COMMAND line" : "");
+}
+
+void UARTManager::_stop_io_threads()
+{
+    _io_stop = true;
+    if (_rx_thread.joinable())
+    {
+        uint64_t one = 1;
+        if (::write(_wake_fd, &one, sizeof(one)) < 0)
+            Debug_printf("UART eventfd write error %d: %s\n", errno, strerror(errno));
+        _rx_thread.join();
+    }
+    if (_line_thread.joinable())
+    {
+        // repeat until line thread is out of TIOCMIWAIT
+        while (!_line_done)
+        {
+            pthread_kill(_line_thread.native_handle(), SIGUSR2);
+            fnSystem.delay_microseconds(1000);
+        }
+        _line_thread.join();
+    }
+    if (_wake_fd >= 0)
+    {
+        close(_wake_fd);
+        _wake_fd = -1;
+    }
+    _line_watch = false;
+}
+
+void UARTManager::_notify_event()
+{
+    _io_events++;
+    {
+        // empty critical section, waiter is either before the check or already waiting
+        std::lock_guard<std::mutex> lock(_event_mutex);
+    }
+    _event_cv.notify_all();
+    // service loop may sleep
+    fnEventLoop.wake();
+}
+
+/* Wait for data in receive ring (any_event = false) or for any serial event
+   (data, COMMAND line change) since the last call (any_event = true)
+ */
+bool UARTManager::_wait_event(uint32_t timeout_ms, bool any_event)
+{
+    auto ready = [&]() {
+        if (_io_error)
+            return true;
+        if (any_event)
+            return _io_events != _poll_events || _command_edge;
+        return !_rx_ring.empty();
+    };
+
+    bool result = ready();
+    if (!result)
+    {
+        std::unique_lock<std::mutex> lock(_event_mutex);
+        result = _event_cv.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+    }
+    if (any_event)
+        _poll_events = _io_events;
+    return result && !_io_error;
+}
+
+void UARTManager::_rx_thread_loop()
+{
+    uint8_t buf[512];
+    struct pollfd fds[2];
+    fds[0].fd = _fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = _wake_fd;
+    fds[1].events = POLLIN;
+
+    while (!_io_stop)
+    {
+        int result = ::poll(fds, 2, -1);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            Debug_printf("UART reader poll error %d: %s\n", errno, strerror(errno));
+            break;
+        }
+        if (fds[1].revents)
+            break; // stop request
+        if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))
+        {
+            Debug_println("UART reader: serial port error");
+            break;
+        }
+        if (!(fds[0].revents & POLLIN))
+            continue;
+
+        // read no more than the ring can take, rest stays in kernel buffer
+        size_t room = _rx_ring.room();
+        if (room == 0)
+        {
+            if (++_rx_overruns == 1)
+                Debug_println("UART reader: receive ring full");
+            _notify_event();
+            fnSystem.delay_microseconds(1000);
+            continue;
+        }
+        ssize_t rxbytes = ::read(_fd, buf, room < sizeof(buf) ? room : sizeof(buf));
+        if (rxbytes < 0)
+        {
+            if (errno == EAGAIN || errno == EINTR)
+                continue;
+            Debug_printf("UART reader read error %d: %s\n", errno, strerror(errno));
+            break;
+        }
+        if (rxbytes == 0)
+            continue;
+        _rx_ring.put(buf, rxbytes);
+        _notify_event();
+    }
+
+    if (!_io_stop)
+    {
+        _io_error = true;
+        _notify_event();
+    }
+}
+
+static int _command_icount(const struct serial_icounter_struct &ic, int tiocm)
+{
+    switch (tiocm)
+    {
+    case TIOCM_DSR:
+        return ic.dsr;
+    case TIOCM_CTS:
+        return ic.cts;
+    default:
+        return ic.rng;
+    }
+}
+
+void UARTManager::_line_thread_loop()
+{
+    struct serial_icounter_struct ic;
+    bool have_icount = (ioctl(_fd, TIOCGICOUNT, &ic) == 0);
+    int last_count = have_icount ? _command_icount(ic, _command_tiocm) : 0;
+    int status;
+
+    while (!_io_stop)
+    {
+        if (ioctl(_fd, TIOCMIWAIT, _command_tiocm) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            // driver without TIOCMIWAIT, command_asserted() falls back to TIOCMGET
+            Debug_printf("UART TIOCMIWAIT error %d: %s\n", errno, strerror(errno));
+            _line_watch = false;
+            break;
+        }
+        uint64_t t = fnSystem.micros();
+
+        if (ioctl(_fd, TIOCMGET, &status) < 0)
+            continue;
+        bool asserted = (status & _command_tiocm) != 0;
+
+        // line may have toggled twice before TIOCMGET, check transition counter
+        int edges = 0;
+        if (have_icount && ioctl(_fd, TIOCGICOUNT, &ic) == 0)
+        {
+            int count = _command_icount(ic, _command_tiocm);
+            edges = count - last_count;
+            last_count = count;
+        }
+
+        if (asserted ? !_command_state : edges >= 2)
+        {
+            _command_time = t;
+            _command_edge = true;
+        }
+        _command_state = asserted;
+        _notify_event();
+    }
+    _line_done = true;
+}
+#endif // __linux__
+
 // end of Linux and macOS UART code
 #endif 
 
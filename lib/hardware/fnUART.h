@@ -10,6 +10,17 @@
 #include <string>
 #include <cstdint>
 
+#if defined(__linux__)
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "spsc_ring.h"
+
+// size of receive ring filled by serial reader thread
+#define UART_RX_RING_SIZE 4096
+#endif
+
 
 class UARTManager
 {
@@ -31,6 +42,34 @@ private:
     int _proceed_tiocm;
     int _fd;
 #endif
+
+#if defined(__linux__)
+    // serial I/O threads, reader thread owns reading from _fd and fills the ring,
+    // line thread waits for COMMAND line changes (TIOCMIWAIT)
+    SpscRing<uint8_t, UART_RX_RING_SIZE> _rx_ring;
+    std::thread _rx_thread;
+    std::thread _line_thread;
+    int _wake_fd = -1; // eventfd to wake up reader thread
+    std::atomic<bool> _io_stop{false};
+    std::atomic<bool> _io_error{false};
+    std::atomic<bool> _line_done{false};
+    std::atomic<bool> _line_watch{false}; // true if COMMAND line is watched by line thread
+    std::atomic<bool> _command_state{false};
+    std::atomic<bool> _command_edge{false}; // latched COMMAND assert
+    std::atomic<uint64_t> _command_time{0}; // time of last COMMAND assert (us)
+    std::atomic<uint32_t> _io_events{0}; // incremented on received data or line change
+    uint32_t _poll_events = 0;
+    uint32_t _rx_overruns = 0;
+    std::mutex _event_mutex;
+    std::condition_variable _event_cv;
+
+    void _start_io_threads();
+    void _stop_io_threads();
+    void _rx_thread_loop();
+    void _line_thread_loop();
+    void _notify_event();
+    bool _wait_event(uint32_t timeout_ms, bool any_event);
+#endif
     // QueueHandle_t _uart_q;
     bool _initialized = false; // is UART ready?
 
@@ -58,6 +97,8 @@ public:
     uint32_t get_baudrate() { return _baud; }
 
     bool command_asserted();
+    // time (fnSystem.micros) of last COMMAND assert edge, 0 if not known
+    uint64_t command_time();
     bool motor_asserted() { return false; } // not pin available
     void set_proceed(bool level);
     void set_interrupt(bool level) {} // not pin available
@@ -7,6 +7,7 @@
 #include "../../include/debug.h"
 
 #include "fnSystem.h"
+#include "fnEventLoop.h"
 #include "fnConfig.h"
 #include "fnWiFi.h"
 #include "fsFlash.h"
@@ -17,6 +18,12 @@
 #include "httpServiceConfigurator.h"
 #include "httpServiceParser.h"
 #include "httpServiceBrowser.h"
+#ifdef BUILD_ATARI
+#include "sio/siostats.h"
+#endif
+#ifdef BUILD_APPLE
+#include "iwm/iwm_slip.h"
+#endif
 
 
 
@@ -147,7 +154,8 @@ void fnHttpService::send_file_parsed(struct mg_connection *c, const char *filena
             fread(buf, 1, sz, fInput);
             string contents(buf);
             free(buf);
-            contents = fnHttpServiceParser::parse_contents(contents);
+            // template tags are substituted with device state, read it on bus thread
+            run_on_bus([&]() { contents = fnHttpServiceParser::parse_contents(contents); });
 
             mg_printf(c, "HTTP/1.1 200 OK\r\n");
             // Set the response content type
@@ -592,6 +600,36 @@ int fnHttpService::get_handler_eject(mg_connection *c, mg_http_message *hm)
     return 0;
 }
 
+#ifdef BUILD_ATARI
+int fnHttpService::get_handler_sio_stats(mg_connection *c, mg_http_message *hm)
+{
+    // get "reset" query variable
+    char reset[10] = "";
+    mg_http_get_var(&hm->query, "reset", reset, sizeof(reset));
+
+    std::string json = fnSioStats.to_json();
+    if (atoi(reset))
+        fnSioStats.reset();
+
+    mg_http_reply(c, 200, "Content-Type: application/json\r\n", "%s", json.c_str());
+    return 0;
+}
+#endif
+
+#ifdef BUILD_APPLE
+int fnHttpService::get_handler_iwm_stats(mg_connection *c, mg_http_message *hm)
+{
+    // get "reset" query variable
+    char reset[10] = "";
+    mg_http_get_var(&hm->query, "reset", reset, sizeof(reset));
+
+    std::string json = smartport.latency_json(atoi(reset) != 0);
+
+    mg_http_reply(c, 200, "Content-Type: application/json\r\n", "%s", json.c_str());
+    return 0;
+}
+#endif
+
 void fnHttpService::cb(struct mg_connection *c, int ev, void *ev_data, void *fn_data)
 {
     static const char *s_root_dir = "data/www";
@@ -629,7 +667,7 @@ void fnHttpService::cb(struct mg_connection *c, int ev, void *ev_data, void *fn_
             // config POST handler
             if (mg_vcasecmp(&hm->method, "POST") == 0)
             {
-                post_handler_config(c, hm);
+                run_on_bus([&]() { post_handler_config(c, hm); });
             }
             else
             {
@@ -639,7 +677,7 @@ void fnHttpService::cb(struct mg_connection *c, int ev, void *ev_data, void *fn_
         else if (mg_http_match_uri(hm, "/print"))
         {
             // print handler
-            get_handler_print(c);
+            run_on_bus([&]() { get_handler_print(c); });
         }
         else if (mg_http_match_uri(hm, "/browse/#"))
         {
@@ -648,19 +686,33 @@ void fnHttpService::cb(struct mg_connection *c, int ev, void *ev_data, void *fn_
         }
         else if (mg_http_match_uri(hm, "/swap"))
         {
-            // browse handler
-            get_handler_swap(c, hm);
+            // swap handler
+            run_on_bus([&]() { get_handler_swap(c, hm); });
         }
         else if (mg_http_match_uri(hm, "/mount"))
         {
-            // browse handler
-            get_handler_mount(c, hm);
+            // mount handler
+            run_on_bus([&]() { get_handler_mount(c, hm); });
         }
         else if (mg_http_match_uri(hm, "/unmount"))
         {
             // eject handler
-            get_handler_eject(c, hm);
+            run_on_bus([&]() { get_handler_eject(c, hm); });
+        }
+#ifdef BUILD_ATARI
+        else if (mg_http_match_uri(hm, "/sio_stats"))
+        {
+            // SIO command timing statistics
+            get_handler_sio_stats(c, hm);
         }
+#endif
+#ifdef BUILD_APPLE
+        else if (mg_http_match_uri(hm, "/iwm_stats"))
+        {
+            // SmartPort request to response latency
+            get_handler_iwm_stats(c, hm);
+        }
+#endif
         else if (mg_http_match_uri(hm, "/restart"))
         {
             // get "exit" query variable
@@ -740,7 +792,18 @@ void fnHttpService::start()
     // esp_event_handler_register(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, &disconnect_handler, &(state.hServer));
 
     // Go ahead and attempt starting the server for the first time
-    start_server(state);
+    if (start_server(state) == nullptr)
+        return;
+
+    // lets other threads interrupt mg_mgr_poll()
+    _wake_pipe = mg_mkpipe(state.hServer, nullptr, nullptr);
+    if (_wake_pipe != nullptr)
+        _wake_sock = (size_t) _wake_pipe->pfn_data;
+
+    // serve requests on separate thread, isolated from bus timing
+    _thread_done = false;
+    _thread_running = true;
+    _thread = std::thread(&fnHttpService::thread_loop, this);
 }
 
 void fnHttpService::stop()
@@ -749,14 +812,149 @@ void fnHttpService::stop()
     {
         Debug_println("Stopping web service");
         // httpd_stop(state.hServer);
+        // let web server thread finish, jobs it may wait for must be run
+        _thread_running = false;
+        while (!_thread_done)
+        {
+            run_bus_jobs();
+            fnSystem.delay(1);
+        }
+        _thread.join();
+        // stop stream producers
+        for (auto &stream : _streams)
+        {
+            stream->closed = true;
+            stream->notify();
+        }
+        _streams.clear();
+        _tasks.shutdown();
         mg_mgr_free(state.hServer);
+        if (_wake_pipe != nullptr)
+        {
+#ifdef _WIN32
+            closesocket((SOCKET) _wake_sock);
+#else
+            close((int) _wake_sock);
+#endif
+            _wake_pipe = nullptr;
+        }
         state._FS = nullptr;
         state.hServer = nullptr;
     }
 }
 
+void fnHttpService::thread_loop()
+{
+    _thread_id = std::this_thread::get_id();
+    Debug_println("Web server thread started");
+    bool idle = true;
+    while (_thread_running)
+    {
+        // don't block in poll while a task has work to do
+        mg_mgr_poll(state.hServer, idle ? FNWS_POLL_MS : 0);
+        service_streams();
+        idle = _tasks.service();
+    }
+    _thread_done = true;
+}
+
+std::shared_ptr<fnHttpStream> fnHttpService::open_stream(struct mg_connection *c)
+{
+    auto stream = std::make_shared<fnHttpStream>();
+    stream->conn_id = c->id;
+    _streams.push_back(stream);
+    return stream;
+}
+
+void fnHttpService::service_streams()
+{
+    uint8_t buf[FNWS_SEND_BUFF_SIZE];
+
+    for (auto it = _streams.begin(); it != _streams.end();)
+    {
+        fnHttpStream *stream = it->get();
+
+        // connection may be closed by client meanwhile
+        struct mg_connection *c = state.hServer->conns;
+        while (c != nullptr && c->id != stream->conn_id)
+            c = c->next;
+        if (c == nullptr || stream->aborted)
+        {
+            if (c != nullptr)
+                c->is_closing = 1;
+            stream->closed = true;
+            stream->notify();
+            it = _streams.erase(it);
+            continue;
+        }
+
+        // move data from ring to connection, unless client is too slow
+        bool drained = false;
+        while (c->send.len < FNWS_STREAM_HIGH_WATER && !stream->ring.empty())
+        {
+            size_t count = stream->ring.get(buf, sizeof(buf));
+            mg_send(c, buf, count);
+            drained = true;
+        }
+        if (drained)
+            stream->notify();
+
+        if (stream->eof && stream->ring.empty())
+            it = _streams.erase(it);
+        else
+            ++it;
+    }
+}
+
+void fnHttpService::wake()
+{
+    if (_wake_pipe == nullptr)
+        return;
+    // any data on the pipe makes mg_mgr_poll() return
+#ifdef _WIN32
+    send((SOCKET) _wake_sock, "", 1, 0);
+#else
+    send((int) _wake_sock, "", 1, MSG_DONTWAIT);
+#endif
+}
+
+void fnHttpService::run_on_bus(std::function<void()> fn)
+{
+    // not called from web server thread, just run it
+    if (!fnHTTPD._thread_running || std::this_thread::get_id() != fnHTTPD._thread_id)
+    {
+#if defined(BUILD_APPLE) && SMARTPORT == SLIP
+        smartport.wait_for_units();
+#endif
+        fn();
+        return;
+    }
+
+    bus_job job;
+    job.fn = fn;
+    std::future<void> done = job.done.get_future();
+    while (!fnHTTPD._bus_jobs.put(&job))
+        fnSystem.delay(1);
+    fnEventLoop.wake();
+    done.wait();
+}
+
+void fnHttpService::run_bus_jobs()
+{
+    bus_job *job;
+    while (_bus_jobs.get(job))
+    {
+#if defined(BUILD_APPLE) && SMARTPORT == SLIP
+        // jobs mount and eject disks, unit workers must not be using them
+        smartport.wait_for_units();
+#endif
+        job->fn();
+        job->done.set_value();
+    }
+}
+
 void fnHttpService::service()
 {
     if (state.hServer != nullptr)
-        mg_mgr_poll(state.hServer, 0);
+        run_bus_jobs();
 }
@@ -9,6 +9,18 @@ URI: "/" - Forces loading/parsing (see below) of /<FNWS_FILE_ROOT>/index.html
 URI: "/file?<filename>" - Sends static file /<FNWS_FILE_ROOT>/<filename>
 URI: "/favico.ico" - Sends /<FNWS_FILE_ROOT>/favico.ico
 URI: "/print" - Sends current printer output to user
+URI: "/sio_stats" - Sends SIO command timing statistics as JSON (Atari only),
+    "/sio_stats?reset=1" clears them after sending
+URI: "/iwm_stats" - Sends SmartPort request to response latency as JSON (Apple
+    only), "/iwm_stats?reset=1" clears it after sending
+
+The web server runs in its own thread. Handlers which touch devices (mount,
+eject, swap, config, print) or read their state (parsed templates) are passed
+to the bus thread with run_on_bus() and executed between bus commands, while
+the web thread waits for them to complete.
+
+File downloads are read by fnTaskManager worker threads into a fnHttpStream
+and passed to the connection by the web thread, see open_stream().
 
 MIME types are assigned based on file extention.  See/update
     static std::map<string, string> mime_map
@@ -33,9 +45,19 @@ If a file has an extention pre-determined to support parsing (see/update
 #include "mongoose.h"
 
 // #include <map>
+#include <list>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <functional>
 #include "string"
 
 #include "fnFS.h"
+#include "fnTaskManager.h"
+#include "spsc_ring.h"
 
 // FNWS_FILE_ROOT should end in a slash '/'
 #define FNWS_FILE_ROOT "/www/"
@@ -49,6 +71,30 @@ If a file has an extention pre-determined to support parsing (see/update
 
 #define PRINTER_BUSY_TIME 2000 // milliseconds to wait until printer is done
 
+#define FNWS_POLL_MS 50 // web server thread poll interval
+#define FNWS_BUS_QUEUE_SIZE 8 // web server -> bus thread job queue
+#define FNWS_STREAM_BUFF_SIZE 65536 // worker thread -> web server thread stream buffer
+#define FNWS_STREAM_HIGH_WATER 65536 // don't feed connection with more unsent data than this
+
+// data produced by worker thread and sent to connection by web server thread
+struct fnHttpStream
+{
+    unsigned long conn_id;
+    SpscRing<uint8_t, FNWS_STREAM_BUFF_SIZE> ring;
+    std::atomic<bool> eof{false};       // producer: all data is in the ring
+    std::atomic<bool> aborted{false};   // producer: failed, close the connection
+    std::atomic<bool> closed{false};    // web server thread: connection is gone, stop producing
+    std::mutex mutex;                   // producer waits on drained for room in the ring
+    std::condition_variable drained;
+
+    // web server thread: wake producer after taking data from ring or closing
+    void notify()
+    {
+        { std::lock_guard<std::mutex> lock(mutex); }
+        drained.notify_one();
+    }
+};
+
 class fnHttpService 
 {
     struct serverstate {
@@ -57,6 +103,29 @@ class fnHttpService
         FileSystem *_FS = nullptr;
     } state;
 
+    // web server thread
+    std::thread _thread;
+    std::atomic<bool> _thread_running{false};
+    std::atomic<bool> _thread_done{false};
+    std::thread::id _thread_id;
+    fnTaskManager _tasks; // tasks running on web server thread (file downloads)
+    void thread_loop();
+
+    // jobs to be executed on bus thread
+    struct bus_job
+    {
+        std::function<void()> fn;
+        std::promise<void> done;
+    };
+    SpscRing<bus_job *, FNWS_BUS_QUEUE_SIZE> _bus_jobs;
+    void run_bus_jobs();
+
+    // streams fed by worker threads, web server thread only
+    std::list<std::shared_ptr<fnHttpStream>> _streams;
+    void service_streams();
+    struct mg_connection *_wake_pipe = nullptr;
+    size_t _wake_sock = 0;
+
     enum _fnwserr
     {
         fnwserr_noerrr = 0,
@@ -116,10 +185,26 @@ public:
     static int post_handler_config(struct mg_connection *c, struct mg_http_message *hm);
 
     static int get_handler_browse(mg_connection *c, mg_http_message *hm);
+#ifdef BUILD_ATARI
+    static int get_handler_sio_stats(mg_connection *c, mg_http_message *hm);
+#endif
+#ifdef BUILD_APPLE
+    static int get_handler_iwm_stats(mg_connection *c, mg_http_message *hm);
+#endif
 
     
+    // called from web server thread, executes fn on bus thread and waits for it
+    static void run_on_bus(std::function<void()> fn);
+    // submit task to be run on web server thread (or its worker threads)
+    int submit_task(fnTask *t) { return _tasks.submit_task(t); }
+    // called from web server thread, returns stream to be filled by other thread
+    std::shared_ptr<fnHttpStream> open_stream(struct mg_connection *c);
+    // wake up web server thread, safe to call from any thread
+    void wake();
+
     void start();
     void stop();
+    // run pending web server jobs, called from bus thread
     void service();
     bool running(void) {
         return state.hServer != nullptr;
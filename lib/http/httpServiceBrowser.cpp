@@ -9,34 +9,39 @@
 #include "fnFsFTP.h"
 #include "fnTaskManager.h"
 #include "fnConfig.h"
+#include "fnSystem.h"
 
 #include "debug.h"
 
 
+#define FNWS_STREAM_CHUNK_SIZE 8192 // file read size of fnHttpSendFileTask
+
+// Reads file in worker thread, web server thread sends the data from stream
 class fnHttpSendFileTask : public fnTask
 {
 public:
-    fnHttpSendFileTask(FileSystem *fs, FileHandler *fh, mg_connection *c);
+    fnHttpSendFileTask(FileSystem *fs, FileHandler *fh, std::shared_ptr<fnHttpStream> stream);
 protected:
     virtual int start() override;
     virtual int abort() override;
     virtual int step() override;
 private:
-    char buf[FNWS_SEND_BUFF_SIZE];
+    uint8_t buf[FNWS_STREAM_CHUNK_SIZE];
     FileSystem * _fs;
     FileHandler * _fh;
-    mg_connection * _c;
+    std::shared_ptr<fnHttpStream> _stream;
     size_t _filesize;
     size_t _total;
 };
 
-fnHttpSendFileTask::fnHttpSendFileTask(FileSystem *fs, FileHandler *fh, mg_connection *c)
+fnHttpSendFileTask::fnHttpSendFileTask(FileSystem *fs, FileHandler *fh, std::shared_ptr<fnHttpStream> stream)
 {
     _fs = fs;
     _fh = fh;
-    _c = c;
+    _stream = stream;
     _filesize = 0;
     _total = 0;
+    _threaded = true;
 }
 
 int fnHttpSendFileTask::start()
@@ -50,27 +55,48 @@ int fnHttpSendFileTask::abort()
 {
     _fh->close(); // close (and delete) FileHandler
     delete _fs; // delete temporary FileSystem
+    _stream->aborted = true;
+    fnHTTPD.wake();
     Debug_printf("fnHttpSendFileTask aborted #%d\n", _id);
     return 0;
 }
 
 int fnHttpSendFileTask::step()
 {
-    Debug_printf("fnHttpSendFileTask::step #%d\n", _id);
+    // client is gone
+    if (_stream->closed)
+        return -1;
+
+    // wait for web server thread to catch up, it notifies after draining the ring
+    if (_stream->ring.room() < sizeof(buf))
+    {
+        std::unique_lock<std::mutex> lock(_stream->mutex);
+        _stream->drained.wait_for(lock, std::chrono::milliseconds(FNWS_POLL_MS), [this]() {
+            return _stream->ring.room() >= sizeof(buf) || _stream->closed;
+        });
+        return 0;
+    }
 
-    // Send the file content out in chunks
+    // Pass the file content to web server thread in chunks
     size_t count = 0;
-    count = _fh->read((uint8_t *)buf, 1, FNWS_SEND_BUFF_SIZE);
+    count = _fh->read(buf, 1, sizeof(buf));
     _total += count;
-    mg_send(_c, buf, count);
+    _stream->ring.put(buf, count);
+    if (_filesize)
+        set_progress((int)((uint64_t)_total * 100 / _filesize));
 
     if (count)
+    {
+        fnHTTPD.wake();
         return 0; // continue
+    }
 
     // done
     _fh->close(); // close (and delete) FileHandler
     delete _fs;  // delete temporary FileSystem
-    Debug_printf("Sent %lu of %lu bytes\n", (unsigned long)_total, (unsigned long)_filesize);
+    _stream->eof = true;
+    fnHTTPD.wake();
+    Debug_printf("Read %lu of %lu bytes #%d\n", (unsigned long)_total, (unsigned long)_filesize, _id);
 
     return 1; // task has completed
 }
@@ -134,6 +160,86 @@ int fnHttpServiceBrowser::browse_html_escape(const char *src, size_t src_len, ch
 }
 
 
+void fnHttpServiceBrowser::browse_drive_action(const char *action, int slot, int drive_slot, const char *path, fnConfig::mount_mode_t mount_mode)
+{
+    if (strcmp(action, "newmount") == 0)
+    {
+        // mount image to drive slot
+        if (drive_slot >=0 && drive_slot < MAX_DISK_DEVICES)
+        {
+            // update config
+            Config.store_mount(drive_slot, slot, path, mount_mode);
+            Config.save();
+
+#ifdef BUILD_ATARI // OS
+            // umount current image, if any - close image file, reset drive slot
+            theFuji.sio_disk_image_umount(false, drive_slot);
+#endif
+
+            // update drive slot
+            fujiDisk &fnDisk = *theFuji.get_disks(drive_slot);
+            fnDisk.host_slot = slot;
+            fnDisk.access_mode = (mount_mode == fnConfig::MOUNTMODE_WRITE) ? DISK_ACCESS_MODE_WRITE : DISK_ACCESS_MODE_READ;
+            strlcpy(fnDisk.filename, path, sizeof(fnDisk.filename));
+
+#ifdef BUILD_ATARI // OS
+            // mount host (file system)
+            if (theFuji.sio_mount_host(false, slot) == 0)
+            {
+                // mount disk image
+                theFuji.sio_disk_image_mount(false, drive_slot);
+            }
+#endif
+        }
+    }
+    else if (strcmp(action, "mount") == 0)
+    {
+        if (drive_slot >=0 && drive_slot < MAX_DISK_DEVICES)
+        {
+#ifdef BUILD_ATARI // OS
+            // mount host (file system)
+            if (theFuji.sio_mount_host(false, theFuji.get_disks(drive_slot)->host_slot) == 0)
+            {
+                // mount disk image
+                theFuji.sio_disk_image_mount(false, drive_slot);
+            }
+#endif
+        }
+    }
+    else if (strcmp(action, "eject") == 0)
+    {
+        // umount image from drive slot
+        if (drive_slot >=0 && drive_slot < MAX_DISK_DEVICES)
+        {
+            Config.clear_mount(drive_slot);
+            Config.save();
+#ifdef BUILD_ATARI // OS
+            theFuji.sio_disk_image_umount(false, drive_slot);
+#endif
+            // Finally, scan all device slots, if all empty, and config enabled, enable the config device.
+            if (Config.get_general_config_enabled())
+            {
+                if ((theFuji.get_disks(0)->host_slot == 0xFF) &&
+                    (theFuji.get_disks(1)->host_slot == 0xFF) &&
+                    (theFuji.get_disks(2)->host_slot == 0xFF) &&
+                    (theFuji.get_disks(3)->host_slot == 0xFF) &&
+                    (theFuji.get_disks(4)->host_slot == 0xFF) &&
+                    (theFuji.get_disks(5)->host_slot == 0xFF) &&
+                    (theFuji.get_disks(6)->host_slot == 0xFF) &&
+                    (theFuji.get_disks(7)->host_slot == 0xFF))
+                {
+                    theFuji.boot_config = true;
+        #ifdef BUILD_ATARI
+                    theFuji.status_wait_count = 5;
+        #endif
+                    theFuji.device_active = true;
+                }
+            }
+        }
+    }
+}
+
+
 int fnHttpServiceBrowser::browse_listdir(mg_connection *c, mg_http_message *hm, FileSystem *fs, int slot, const char *host_path, unsigned pathlen)
 {
     char path[256];
@@ -187,82 +293,7 @@ int fnHttpServiceBrowser::browse_listdir(mg_connection *c, mg_http_message *hm,
         fnConfig::mount_mode_t mount_mode = (mode_str[0] == 'w' && mode_str[1] == '\0') \
             ? fnConfig::MOUNTMODE_WRITE : fnConfig::MOUNTMODE_READ;
 
-        if (strcmp(action, "newmount") == 0)
-        {
-            // mount image to drive slot
-            if (drive_slot >=0 && drive_slot < MAX_DISK_DEVICES)
-            {
-                // update config
-                Config.store_mount(drive_slot, slot, path, mount_mode);
-                Config.save();
-
-#ifdef BUILD_ATARI // OS
-                // umount current image, if any - close image file, reset drive slot
-                theFuji.sio_disk_image_umount(false, drive_slot);
-#endif
-
-                // update drive slot
-                fujiDisk &fnDisk = *theFuji.get_disks(drive_slot);
-                fnDisk.host_slot = slot;
-                fnDisk.access_mode = (mount_mode == fnConfig::MOUNTMODE_WRITE) ? DISK_ACCESS_MODE_WRITE : DISK_ACCESS_MODE_READ;
-                strlcpy(fnDisk.filename, path, sizeof(fnDisk.filename));
-
-#ifdef BUILD_ATARI // OS
-                // mount host (file system)
-                if (theFuji.sio_mount_host(false, slot) == 0)
-                {
-                    // mount disk image
-                    theFuji.sio_disk_image_mount(false, drive_slot);
-                }
-#endif
-            }
-        }
-        else if (strcmp(action, "mount") == 0)
-        {
-            if (drive_slot >=0 && drive_slot < MAX_DISK_DEVICES)
-            {
-#ifdef BUILD_ATARI // OS
-                // mount host (file system)
-                if (theFuji.sio_mount_host(false, theFuji.get_disks(drive_slot)->host_slot) == 0)
-                {
-                    // mount disk image
-                    theFuji.sio_disk_image_mount(false, drive_slot);
-                }
-#endif
-            }
-        }
-        else if (strcmp(action, "eject") == 0)
-        {
-            // umount image from drive slot
-            if (drive_slot >=0 && drive_slot < MAX_DISK_DEVICES)
-            {
-                Config.clear_mount(drive_slot);
-                Config.save();
-#ifdef BUILD_ATARI // OS
-                theFuji.sio_disk_image_umount(false, drive_slot);
-#endif
-                // Finally, scan all device slots, if all empty, and config enabled, enable the config device.
-                if (Config.get_general_config_enabled())
-                {
-                    if ((theFuji.get_disks(0)->host_slot == 0xFF) &&
-                        (theFuji.get_disks(1)->host_slot == 0xFF) &&
-                        (theFuji.get_disks(2)->host_slot == 0xFF) &&
-                        (theFuji.get_disks(3)->host_slot == 0xFF) &&
-                        (theFuji.get_disks(4)->host_slot == 0xFF) &&
-                        (theFuji.get_disks(5)->host_slot == 0xFF) &&
-                        (theFuji.get_disks(6)->host_slot == 0xFF) &&
-                        (theFuji.get_disks(7)->host_slot == 0xFF))
-                    {
-                        theFuji.boot_config = true;
-            #ifdef BUILD_ATARI
-                        theFuji.status_wait_count = 5;
-            #endif
-                        theFuji.device_active = true;
-                    }
-                }
-            }
-        }
-        else if (strcmp(action, "download") == 0)
+        if (strcmp(action, "download") == 0)
         {
             FileHandler *fh = fs->filehandler_open(path);
             if (fh != nullptr)
@@ -277,8 +308,15 @@ int fnHttpServiceBrowser::browse_listdir(mg_connection *c, mg_http_message *hm,
                 return -1;
             }
         }
+        else
+        {
+            // mount and eject touch devices, run them on bus thread between bus commands
+            fnHttpService::run_on_bus([&]() { browse_drive_action(action, slot, drive_slot, path, mount_mode); });
+        }
         // action "slotlist" goes here
-        return browse_listdrives(c, slot, esc_path, enc_path);
+        int result;
+        fnHttpService::run_on_bus([&]() { result = browse_listdrives(c, slot, esc_path, enc_path); });
+        return result;
     }
 
     // no special action -> entering sub-directory
@@ -495,7 +533,8 @@ int fnHttpServiceBrowser::browse_sendfile(mg_connection *c, FileSystem *fs, File
     mg_printf(c, "Content-Length: %lu\r\n\r\n", filesize);
 
     // Create a task to send the file content out
-    fnTask *task = new fnHttpSendFileTask(fs, fh, c);
+    std::shared_ptr<fnHttpStream> stream = fnHTTPD.open_stream(c);
+    fnTask *task = new fnHttpSendFileTask(fs, fh, stream);
     if (task == nullptr)
     {
         Debug_println("Failed to create fnHttpSendFileTask");
@@ -503,7 +542,14 @@ int fnHttpServiceBrowser::browse_sendfile(mg_connection *c, FileSystem *fs, File
         fh->close();
         return -1;
     }
-    return (taskMgr.submit_task(task) > 0) ? 1 : 0; // 1 -> do not delete the file system, if task was submitted
+    // task runs on worker thread
+    if (fnHTTPD.submit_task(task) > 0)
+        return 1; // 1 -> do not delete the file system, if task was submitted
+    Debug_println("Failed to submit fnHttpSendFileTask");
+    delete task;
+    fh->close(); // close (and delete) FileHandler, caller deletes the file system
+    stream->aborted = true;
+    return 0;
 }
 
 
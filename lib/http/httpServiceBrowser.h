@@ -2,6 +2,7 @@
 #define HTTPSERVICEBROWSER_H
 
 #include "fnFS.h"
+#include "fnConfig.h"
 #include "mongoose.h"
 
 class fnHttpServiceBrowser
@@ -9,6 +10,7 @@ class fnHttpServiceBrowser
     static int browse_url_encode(const char *src, size_t src_len, char *dst, size_t dst_len);
     static int browse_html_escape(const char *src, size_t src_len, char *dst, size_t dst_len);
 
+    static void browse_drive_action(const char *action, int slot, int drive_slot, const char *path, fnConfig::mount_mode_t mount_mode);
     static int browse_listdir(mg_connection *c, mg_http_message *hm, FileSystem *pFS, int slot, const char *host_path, unsigned pathlen);
     static int browse_listdrives(mg_connection *c, int slot, const char *esc_path, const char *enc_path);
     static void print_head(mg_connection *c, int slot);
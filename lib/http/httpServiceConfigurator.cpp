@@ -10,6 +10,7 @@
 #include "bus.h"
 
 #include "utils.h"
+#include "debug_log.h"
 
 
 #ifdef BUILD_APPLE
@@ -446,6 +447,19 @@ void fnHttpServiceConfigurator::config_cpm_ccp(std::string cpm_ccp)
     Config.save();
 }
 
+void fnHttpServiceConfigurator::config_debug_levels(std::string debug_levels)
+{
+    Debug_printf("New debug levels: %s\n", debug_levels.c_str());
+
+    // Apply it immediately
+    if (!util_debug_set_levels(debug_levels))
+        Debug_println("Unknown debug subsystem name");
+    // Store our change in Config
+    Config.store_general_debug_levels(util_debug_get_levels().c_str());
+    // Save change
+    Config.save();
+}
+
 void fnHttpServiceConfigurator::config_serial(std::string port, std::string command, std::string proceed)
 {
     Debug_printf("Set Serial: %s,%s,%s\n", port.c_str(), command.c_str(), proceed.c_str());
@@ -497,6 +511,19 @@ void fnHttpServiceConfigurator::config_serial(std::string port, std::string comm
     Config.save();
 }
 
+void fnHttpServiceConfigurator::config_serial_precise_timing(std::string precise_timing)
+{
+    Debug_printf("New serial precise timing value: %s\n", precise_timing.c_str());
+
+    // Store our change in Config
+    Config.store_serial_precise_timing(util_string_value_is_true(precise_timing));
+    // Apply it immediately
+    fnSystem.set_delay_mode(Config.get_serial_precise_timing() ?
+        SystemManager::DELAY_MODE_PRECISE : SystemManager::DELAY_MODE_SLEEP);
+    // Save change
+    Config.save();
+}
+
 void fnHttpServiceConfigurator::config_netsio(std::string enable_netsio, std::string netsio_host_port)
 {
 #ifdef BUILD_ATARI // OS
@@ -533,6 +560,16 @@ void fnHttpServiceConfigurator::config_netsio(std::string enable_netsio, std::st
 #endif /* ATARI */
 }
 
+void fnHttpServiceConfigurator::config_boip_transport(std::string boip_transport)
+{
+    Debug_printf("New BOIP transport: %s\n", boip_transport.c_str());
+
+    // Store our change in Config, used when connecting to emulator next time
+    Config.store_boip_udp(strcasecmp(boip_transport.c_str(), "udp") == 0);
+    // Save change
+    Config.save();
+}
+
 int fnHttpServiceConfigurator::process_config_post(const char *postdata, size_t postlen)
 {
 #ifdef DEBUG
@@ -636,6 +673,10 @@ int fnHttpServiceConfigurator::process_config_post(const char *postdata, size_t
         {
             config_cpm_ccp(i->second);
         }
+        else if (i->first.compare("debug_levels") == 0)
+        {
+            config_debug_levels(i->second);
+        }
         else if (i->first.compare("serial_port") == 0)
         {
             config_serial(i->second, std::string(), std::string());
@@ -648,6 +689,14 @@ int fnHttpServiceConfigurator::process_config_post(const char *postdata, size_t
         {
             config_serial(std::string(), std::string(), i->second);
         }
+        else if (i->first.compare("serial_precise_timing") == 0)
+        {
+            config_serial_precise_timing(i->second);
+        }
+        else if (i->first.compare("boip_transport") == 0)
+        {
+            config_boip_transport(i->second);
+        }
         else if (i->first.compare("netsio_enable") == 0)
         {
             str_netsio_enable = i->second;
@@ -32,9 +32,12 @@ class fnHttpServiceConfigurator
     static void config_apetime_enabled(std::string apetime_enabled);
     static void config_cpm_enabled(std::string cpm_enabled);
     static void config_cpm_ccp(std::string cpm_ccp);
+    static void config_debug_levels(std::string debug_levels);
 
     static void config_serial(std::string port, std::string command, std::string proceed);
+    static void config_serial_precise_timing(std::string precise_timing);
     static void config_netsio(std::string enable_netsio, std::string netsio_host_port);
+    static void config_boip_transport(std::string boip_transport);
 
 public:
     static char * url_decode(char * dst, const char * src, size_t dstsize);
@@ -17,6 +17,7 @@
 #include "fnFsSD.h"
 #include "httpService.h"
 #include "fuji.h"
+#include "debug_log.h"
 
 using namespace std;
 
@@ -69,9 +70,11 @@ const string fnHttpServiceParser::substitute_tag(const string &tag)
         FN_SERIAL_PORT,
         FN_SERIAL_COMMAND,
         FN_SERIAL_PROCEED,
+        FN_SERIAL_PRECISE_TIMING,
         FN_SIO_HSTEXT,
         FN_NETSIO_ENABLED,
         FN_NETSIO_HOST,
+        FN_BOIP_UDP,
         FN_DRIVE1HOST,
         FN_DRIVE2HOST,
         FN_DRIVE3HOST,
@@ -127,6 +130,7 @@ const string fnHttpServiceParser::substitute_tag(const string &tag)
         FN_APETIME_ENABLED,
         FN_CPM_ENABLED,
         FN_CPM_CCP,
+        FN_DEBUG_LEVELS,
         FN_LASTTAG
     };
 
@@ -175,9 +179,11 @@ const string fnHttpServiceParser::substitute_tag(const string &tag)
         "FN_SERIAL_PORT",
         "FN_SERIAL_COMMAND",
         "FN_SERIAL_PROCEED",
+        "FN_SERIAL_PRECISE_TIMING",
         "FN_SIO_HSTEXT",
         "FN_NETSIO_ENABLED",
         "FN_NETSIO_HOST",
+        "FN_BOIP_UDP",
         "FN_DRIVE1HOST",
         "FN_DRIVE2HOST",
         "FN_DRIVE3HOST",
@@ -232,7 +238,8 @@ const string fnHttpServiceParser::substitute_tag(const string &tag)
         "FN_ENCRYPT_PASSPHRASE_ENABLED",
         "FN_APETIME_ENABLED",
         "FN_CPM_ENABLED",
-        "FN_CPM_CCP"
+        "FN_CPM_CCP",
+        "FN_DEBUG_LEVELS"
     };
 
     stringstream resultstream;
@@ -372,6 +379,9 @@ const string fnHttpServiceParser::substitute_tag(const string &tag)
     case FN_SERIAL_PROCEED:
         resultstream << Config.get_serial_proceed();
         break;
+    case FN_SERIAL_PRECISE_TIMING:
+        resultstream << Config.get_serial_precise_timing();
+        break;
     case FN_PRINTER1_MODEL:
         {
 #ifdef BUILD_ADAM
@@ -451,6 +461,9 @@ const string fnHttpServiceParser::substitute_tag(const string &tag)
         if (Config.get_netsio_port() != CONFIG_DEFAULT_NETSIO_PORT)
             resultstream << ":" << Config.get_netsio_port();
         break;
+    case FN_BOIP_UDP:
+        resultstream << Config.get_boip_udp();
+        break;
     case FN_DRIVE1HOST:
     case FN_DRIVE2HOST:
     case FN_DRIVE3HOST:
@@ -499,6 +512,26 @@ const string fnHttpServiceParser::substitute_tag(const string &tag)
         if (host_slot != HOST_SLOT_INVALID) {
 	        resultstream << Config.get_mount_path(drive_slot);
 	        resultstream << " (" << (Config.get_mount_mode(drive_slot) == fnConfig::mount_modes::MOUNTMODE_READ ? "R" : "W") << ")";
+#ifdef BUILD_ATARI
+            // why mount_all left the slot empty
+            if (theFuji.get_disks(drive_slot)->fileh == nullptr)
+            {
+                switch (theFuji.get_mount_status(drive_slot))
+                {
+                case MOUNT_STATUS_HOST_FAILED:
+                    resultstream << " - not mounted, host not reachable";
+                    break;
+                case MOUNT_STATUS_OPEN_FAILED:
+                    resultstream << " - not mounted, can't open image";
+                    break;
+                case MOUNT_STATUS_MEDIA_FAILED:
+                    resultstream << " - not mounted, unknown image type";
+                    break;
+                default:
+                    break;
+                }
+            }
+#endif /* BUILD_ATARI */
         } else {
             resultstream << "(Empty)";
         }
@@ -587,6 +620,9 @@ const string fnHttpServiceParser::substitute_tag(const string &tag)
     case FN_CPM_CCP:
         resultstream << Config.get_ccp_filename();
         break;
+    case FN_DEBUG_LEVELS:
+        resultstream << util_debug_get_levels();
+        break;
     default:
         resultstream << tag;
         break;
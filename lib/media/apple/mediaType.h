@@ -84,6 +84,11 @@ public:
     // Returns TRUE if an error condition occurred
     virtual bool write(uint32_t blockNum, uint16_t *count, uint8_t* buffer) = 0;
 
+    // Returns count bytes from blockNum without copying, nullptr if image isn't in memory (use read())
+    virtual const uint8_t *block_ptr(uint32_t blockNum, uint32_t count) { return nullptr; }
+    // writes data held back by write() to the image when it is due, called regularly by bus
+    virtual void sync() {}
+
     // virtual uint16_t sector_size(uint16_t sectornum);
     
     virtual bool status() = 0;
@@ -20,31 +20,16 @@ static const int prodos2dos[8][2] = { {0, 14}, {13, 12}, {11, 10}, {9, 8}, {7, 6
 
 bool MediaTypeDO::read(uint32_t blockNum, uint16_t *count, uint8_t* buffer)
 {
-    bool err = false;
     uint32_t track = blockNum / BLOCKS_PER_TRACK;
     const int* sectors = prodos2dos[blockNum % BLOCKS_PER_TRACK];
 
-    err = read_sector(track, sectors[0], buffer);
-
-    if (!err)
-        err = read_sector(track, sectors[1], &buffer[BYTES_PER_SECTOR]);
-
-    return err;
-}
-
-bool MediaTypeDO::read_sector(int track, int sector, uint8_t* buffer)
-{
-    Debug_printf("\r\nMediaTypeDO read track %d sector %d", track, sector);
-    
-    bool err = false;
-    uint32_t offset = (track * BYTES_PER_TRACK) + (sector * BYTES_PER_SECTOR);
-
-    err = _media_fileh->seek(offset, SEEK_SET) != 0;
-
-    if (!err)
-        err = _media_fileh->read(buffer, 1, BYTES_PER_SECTOR) != BYTES_PER_SECTOR;
+    const uint8_t *track_data = _track_cache.track(track);
+    if (track_data == nullptr)
+        return true;
 
-    return err;
+    memcpy(buffer, &track_data[sectors[0] * BYTES_PER_SECTOR], BYTES_PER_SECTOR);
+    memcpy(&buffer[BYTES_PER_SECTOR], &track_data[sectors[1] * BYTES_PER_SECTOR], BYTES_PER_SECTOR);
+    return false;
 }
 
 bool MediaTypeDO::write(uint32_t blockNum, uint16_t *count, uint8_t* buffer)
@@ -72,15 +57,7 @@ bool MediaTypeDO::write_sector(int track, int sector, uint8_t* buffer)
 {
     Debug_printf("\r\nMediaTypeDO write track %d sector %d", track, sector);
 
-    bool err = false;
-    uint32_t offset = (track * BYTES_PER_TRACK) + (sector * BYTES_PER_SECTOR);
-
-    err = _media_fileh->seek(offset, SEEK_SET) != 0;
-
-    if (!err)
-        err = _media_fileh->write(buffer, 1, BYTES_PER_SECTOR) != BYTES_PER_SECTOR;
-
-    return err;
+    return _track_cache.write(track, sector * BYTES_PER_SECTOR, buffer, BYTES_PER_SECTOR);
 }
 
 bool MediaTypeDO::format(uint16_t *respopnsesize)
@@ -104,7 +81,14 @@ mediatype_t MediaTypeDO::mount(FileHandler *f, uint32_t disksize)
     diskiiemulation = false;
     _media_fileh = f;
     num_blocks = disksize / BYTES_PER_BLOCK;
+    _track_cache.attach(f, disksize / BYTES_PER_TRACK);
     return MEDIATYPE_DO;
 }
 
+void MediaTypeDO::unmount()
+{
+    _track_cache.detach();
+    MediaType::unmount();
+}
+
 #endif // BUILD_APPLE
@@ -4,11 +4,14 @@
 #include <stdio.h>
 
 #include "mediaType.h"
+#include "trackCache.h"
 
 class MediaTypeDO : public MediaType
 {
 private:
-    bool read_sector(int track, int sector, uint8_t* buffer);
+    // whole tracks are read, blocks are assembled from their sectors in memory
+    TrackCache _track_cache;
+
     bool write_sector(int track, int sector, uint8_t* buffer);
 
 public:
@@ -18,6 +21,7 @@ public:
     virtual bool format(uint16_t *respopnsesize) override;
 
     virtual mediatype_t mount(FileHandler *f, uint32_t disksize) override;
+    virtual void unmount() override;
 
     virtual bool status() override {return (_media_fileh != nullptr);}
 };
@@ -35,24 +35,16 @@ mediatype_t MediaTypeDSK::mount(FileHandler *f, uint32_t disksize)
     diskiiemulation = true;
     num_tracks = disksize / BYTES_PER_TRACK;
 
-    // allocated SPRAM
-    const size_t dsk_image_size = num_tracks * BYTES_PER_TRACK;
-#ifdef ESP_PLATFORM
-    uint8_t *dsk = (uint8_t*)heap_caps_malloc(dsk_image_size, MALLOC_CAP_SPIRAM);
-#else
-	uint8_t *dsk = (uint8_t*)malloc(dsk_image_size);
-#endif
-    if (f->seek(0, SEEK_SET) != 0)
-        return MEDIATYPE_UNKNOWN;
-    size_t bytes_read = f->read(dsk, 1, dsk_image_size);
-    if (bytes_read != dsk_image_size)
+    // whole image in one read, track cache is freed when converted
+    TrackCache dsk(num_tracks);
+    dsk.attach(f, num_tracks);
+    if (dsk.preload(0, num_tracks))
         return MEDIATYPE_UNKNOWN;
 
     dsk2woz_info();
     dsk2woz_tmap();
 	dsk2woz_tracks(dsk);
 
-    free(dsk);
     return MEDIATYPE_WOZ;
 }
 
@@ -90,7 +82,7 @@ void MediaTypeDSK::dsk2woz_tmap()
 #endif
 }
 
-bool MediaTypeDSK::dsk2woz_tracks(uint8_t *dsk)
+bool MediaTypeDSK::dsk2woz_tracks(TrackCache &dsk)
 {    // depend upon little endian-ness
 
     // woz1 track data organized as:
@@ -118,11 +110,12 @@ bool MediaTypeDSK::dsk2woz_tracks(uint8_t *dsk)
 #else
 		uint8_t* temp_ptr = (uint8_t *)malloc(WOZ1_NUM_BLKS * 512);
 #endif
-		if (temp_ptr != nullptr)
+		const uint8_t *dsk_track = dsk.track(c);
+		if (temp_ptr != nullptr && dsk_track != nullptr)
 		{
 			trk_ptrs[c] = temp_ptr;
 			memset(trk_ptrs[c], 0, WOZ1_NUM_BLKS * 512);
-			serialise_track(trk_ptrs[c], &dsk[c * 16 * 256], c, _mediatype == MEDIATYPE_PO);
+			serialise_track(trk_ptrs[c], dsk_track, c, _mediatype == MEDIATYPE_PO);
 			temp_ptr += WOZ1_TRACK_LEN;
 			bytes_used = temp_ptr[0] + (temp_ptr[1] << 8);
 			temp_ptr += sizeof(uint16_t);
@@ -4,6 +4,7 @@
 #include <stdio.h>
 
 #include "mediaTypeWOZ.h"
+#include "trackCache.h"
 
 // #define MAX_TRACKS 160
 
@@ -22,7 +23,7 @@ private:
 
     void dsk2woz_info();
     void dsk2woz_tmap();
-    bool dsk2woz_tracks(uint8_t *dsk); 
+    bool dsk2woz_tracks(TrackCache &dsk);
 
 public:
 
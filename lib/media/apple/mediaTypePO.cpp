@@ -4,11 +4,30 @@
 
 #include <cstring>
 #include "utils.h"
+#include "fnSystem.h"
 #include "../../include/debug.h"
 
+const uint8_t *MediaTypePO::block_ptr(uint32_t blockNum, uint32_t count)
+{
+    if (image_map == nullptr)
+        return nullptr;
+    uint64_t start = (uint64_t)blockNum * 512 + offset;
+    if (start + count > image_map_size)
+        return nullptr;
+    return image_map + start;
+}
+
 bool MediaTypePO::read(uint32_t blockNum, uint16_t *count, uint8_t* buffer)
 {
     size_t readsize = *count;
+    if (image_map != nullptr)
+    {
+        const uint8_t *p = block_ptr(blockNum, readsize);
+        if (p == nullptr)
+            return true;
+        memcpy(buffer, p, readsize);
+        return false;
+    }
 if (blockNum == 0 || blockNum != last_block_num + 1) // example optimization, only do seek if not reading next block -tschak
   {
      if (_media_fileh->seek((blockNum * readsize) + offset, SEEK_SET))
@@ -31,6 +50,18 @@ bool MediaTypePO::write(uint32_t blockNum, uint16_t *count, uint8_t* buffer)
 {
     size_t writesize = *count;
 
+    // high score blocks of read-only image go through their own file handle below
+    if (image_map_writable && !(high_score_enabled && blockNum >= _high_score_block_lb && blockNum <= _high_score_block_ub))
+    {
+        uint8_t *p = (uint8_t *)block_ptr(blockNum, writesize);
+        if (p == nullptr)
+            return true;
+        memcpy(p, buffer, writesize);
+        image_map_dirty = true;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(fileh_mutex);
     if (high_score_enabled && blockNum >= _high_score_block_lb && blockNum <= _high_score_block_ub)
     {
         Debug_printf("high score: Swapping file handles\r\n");
@@ -68,6 +99,20 @@ bool MediaTypePO::write(uint32_t blockNum, uint16_t *count, uint8_t* buffer)
     return false;
 }
 
+void MediaTypePO::sync()
+{
+    if (!image_map_dirty)
+        return;
+    uint64_t now = fnSystem.millis();
+    if (now - image_map_synced < PO_MAP_SYNC_MS)
+        return;
+    // writes coming meanwhile mark it dirty again
+    image_map_dirty = false;
+    std::lock_guard<std::mutex> lock(fileh_mutex);
+    _media_fileh->flush();
+    image_map_synced = now;
+}
+
 bool MediaTypePO::format(uint16_t *respopnsesize)
 {
     return false;
@@ -103,9 +148,32 @@ mediatype_t MediaTypePO::mount(FileHandler *f, uint32_t disksize)
   _media_fileh = f;
   disksize -= offset;
   num_blocks = disksize/512;
+
+  // local image, image opened read-only gets read-only mapping
+  image_map = f->mmap_view(&image_map_size, true);
+  image_map_writable = image_map != nullptr;
+  if (image_map == nullptr)
+    image_map = f->mmap_view(&image_map_size);
+  if (image_map != nullptr)
+  {
+    Debug_printf("\r\nImage mapped, %u bytes%s\r\n", (unsigned)image_map_size, image_map_writable ? "" : ", read-only");
+    image_map_synced = fnSystem.millis();
+  }
   return MEDIATYPE_PO;
 }
 
+void MediaTypePO::unmount()
+{
+    if (image_map_dirty && _media_fileh != nullptr)
+        _media_fileh->flush();
+    // mapping goes away with file
+    image_map = nullptr;
+    image_map_size = 0;
+    image_map_writable = false;
+    image_map_dirty = false;
+    MediaType::unmount();
+}
+
 
 // static bool create(FILE *f, uint32_t numBlock)
 // {
@@ -2,21 +2,39 @@
 #define _MEDIATYPE_PO_
 
 #include <stdio.h>
+#include <atomic>
+#include <mutex>
 
 #include "mediaType.h"
 
+#define PO_MAP_SYNC_MS 1000 // writes to mapped image are flushed by sync() this often, and on unmount
+
 class MediaTypePO : public MediaType
 {
 private:
     uint32_t last_block_num = 0xFFFFFFFF;
     uint32_t offset = 0;
+
+    // local image mapped into memory, blocks are served by pointer
+    uint8_t *image_map = nullptr;
+    size_t image_map_size = 0;
+    bool image_map_writable = false;
+    std::atomic<bool> image_map_dirty{false}; // set by write() of disk worker, cleared by sync() of bus
+    uint64_t image_map_synced = 0;
+
+    // write() of disk worker swaps _media_fileh for high score blocks, sync() of bus flushes it
+    std::mutex fileh_mutex;
+
 public:
     virtual bool read(uint32_t blockNum, uint16_t *count, uint8_t* buffer) override;
     virtual bool write(uint32_t blockNum, uint16_t *count, uint8_t* buffer) override;
+    virtual const uint8_t *block_ptr(uint32_t blockNum, uint32_t count) override;
+    virtual void sync() override;
 
     virtual bool format(uint16_t *respopnsesize) override;
 
     virtual mediatype_t mount(FileHandler *f, uint32_t disksize) override;
+    virtual void unmount() override;
 
     virtual bool status() override {return (_media_fileh != nullptr);}
 
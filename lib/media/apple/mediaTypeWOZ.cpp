@@ -11,6 +11,8 @@ mediatype_t MediaTypeWOZ::mount(FileHandler *f, uint32_t disksize)
 {
     _media_fileh = f;
     diskiiemulation = true;
+    // local image, tracks are paged in by OS when touched
+    woz_map = f->mmap_view(&woz_map_size);
     // check WOZ header
     if (wozX_check_header())
         return MEDIATYPE_UNKNOWN;
@@ -22,7 +24,7 @@ mediatype_t MediaTypeWOZ::mount(FileHandler *f, uint32_t disksize)
     if (wozX_read_tmap())
         return MEDIATYPE_UNKNOWN;
         
-    // read TRKS table
+    // read TRKS table, track data is read by get_track()
     switch (woz_version)
     {
     case WOZ1:
@@ -38,22 +40,118 @@ mediatype_t MediaTypeWOZ::mount(FileHandler *f, uint32_t disksize)
         return MEDIATYPE_UNKNOWN;
     }
 
+    // WOZ1 track is followed by its info and padding, which must read as zeros
+    trk_mapped = woz_map != nullptr && woz_version == WOZ2;
+    if (trk_mapped)
+    {
+        Debug_printf("\nWOZ image mapped, %u bytes", (unsigned)woz_map_size);
+        for (int i = 0; i < MAX_TRACKS; i++)
+        {
+            size_t s = trks[i].block_count * 512;
+            if (s != 0 && trk_offsets[i] + s <= woz_map_size)
+                trk_ptrs[i] = woz_map + trk_offsets[i];
+        }
+    }
+
     return MEDIATYPE_WOZ;
 }
 
 void MediaTypeWOZ::unmount()
 {
-    MediaType::unmount();
     for (int i = 0; i < MAX_TRACKS; i++)
     {
         if (trk_ptrs[i] != nullptr)
-            free(trk_ptrs[i]);
+        {
+            if (!trk_mapped)
+                free(trk_ptrs[i]);
+            trk_ptrs[i] = nullptr;
+        }
+        trk_lru[i] = 0;
+    }
+    loaded_tracks = 0;
+    // mapping goes away with file
+    woz_map = nullptr;
+    woz_map_size = 0;
+    trk_mapped = false;
+    MediaType::unmount();
+}
+
+uint8_t *MediaTypeWOZ::get_track(int t)
+{
+    uint8_t i = tmap[t];
+    if (i >= MAX_TRACKS)
+        return nullptr;
+
+    if (trk_ptrs[i] == nullptr && load_track(i))
+        return nullptr;
+    trk_lru[i] = ++lru_clock;
+    return trk_ptrs[i];
+}
+
+bool MediaTypeWOZ::read_at(uint32_t offset, void *buffer, size_t len)
+{
+    if (woz_map != nullptr)
+    {
+        if (offset + len > woz_map_size)
+            return true;
+        memcpy(buffer, woz_map + offset, len);
+        return false;
+    }
+    if (_media_fileh->seek(offset, SEEK_SET))
+        return true;
+    return _media_fileh->read(buffer, 1, len) != len;
+}
+
+// read track into RAM, least recently used track is dropped if too many are loaded
+bool MediaTypeWOZ::load_track(uint8_t i)
+{
+    size_t s = trks[i].block_count * 512;
+    if (s == 0 || trk_mapped)
+        return true; // blank, or beyond end of mapped image
+
+    if (loaded_tracks >= WOZ_TRACK_CACHE_TRACKS)
+    {
+        int victim = -1;
+        for (int j = 0; j < MAX_TRACKS; j++)
+            if (trk_ptrs[j] != nullptr && (victim < 0 || trk_lru[j] < trk_lru[victim]))
+                victim = j;
+        if (victim >= 0)
+        {
+            free(trk_ptrs[victim]);
+            trk_ptrs[victim] = nullptr;
+            loaded_tracks--;
+        }
+    }
+
+#ifdef ESP_PLATFORM
+    uint8_t *p = (uint8_t *)heap_caps_malloc(s, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+#else
+    uint8_t *p = (uint8_t *)malloc(s);
+#endif
+    if (p == nullptr)
+    {
+        Debug_printf("\nNo RAM allocated!");
+        return true;
     }
+    // woz1 track is zero padded after bytes used, like it was when all tracks were read at mount
+    size_t len = (woz_version == WOZ1) ? trk_bytes_used[i] : s;
+    memset(p + len, 0, s - len);
+    Debug_printf("\nReading %d bytes of track %d into location %lu", len, i, p);
+    if (read_at(trk_offsets[i], p, len))
+    {
+        Debug_printf("\nError reading track %d", i);
+        free(p);
+        return true;
+    }
+    trk_ptrs[i] = p;
+    loaded_tracks++;
+    return false;
 }
 
 bool MediaTypeWOZ::wozX_check_header()
 {
-    char hdr[12];
+    // unsigned, 0xFF below never matches a signed char
+    uint8_t hdr[12];
     _media_fileh->read(&hdr, sizeof(char), 12);
     if (hdr[0] == 'W' && hdr[1] == 'O' && hdr[2] == 'Z')
     {
@@ -148,7 +246,13 @@ bool MediaTypeWOZ::wozX_read_tmap()
 
 bool MediaTypeWOZ::woz1_read_tracks()
 {    // depend upon little endian-ness
-    _media_fileh->seek(256, SEEK_SET);
+    uint32_t chunk_size;
+    if (read_at(252, &chunk_size, sizeof(chunk_size)))
+    {
+        Debug_printf("\nError reading TRKS chunk");
+        return true;
+    }
+    int n = chunk_size / WOZ1_TRK_SIZE;
 
     // woz1 track data organized as:
     // Offset	Size	    Name	        Usage
@@ -160,92 +264,48 @@ bool MediaTypeWOZ::woz1_read_tracks()
     // +6653	uint8	    Splice Bit Count	Bit count of splice nibble (write hint).
     // +6654	uint16		Reserved for future use.
 
-    Debug_printf("\nStart Block, Block Count, Bit Count");
-    
-#ifdef ESP_PLATFORM
-    uint8_t *temp_ptr = (uint8_t *)heap_caps_malloc(WOZ1_NUM_BLKS * 512, MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
-#else
-    uint8_t *temp_ptr = (uint8_t *)malloc(WOZ1_NUM_BLKS * 512);
-#endif
-    uint16_t bytes_used;
-    uint16_t bit_count;
+    // only info of tracks in TMAP is read, bitstream is read by get_track()
+    bool used[MAX_TRACKS] = { };
+    for (int t = 0; t < MAX_TRACKS; t++)
+        if (tmap[t] < n && tmap[t] < MAX_TRACKS)
+            used[tmap[t]] = true;
 
+    Debug_printf("\nStart Block, Block Count, Bit Count");
     for (int i = 0; i < MAX_TRACKS; i++)
     {
-        memset(temp_ptr, 0, WOZ1_NUM_BLKS * 512);
-        _media_fileh->read(temp_ptr, 1, WOZ1_TRACK_LEN);
-        _media_fileh->read(&bytes_used, sizeof(bytes_used), 1);
-        _media_fileh->read(&bit_count, sizeof(bit_count), 1);
-        trks[i].block_count = bytes_used / 512;
-        if (bytes_used % 512)
-            trks[i].block_count++;
-        trks[i].bit_count = bit_count;
-        if (bit_count > 0)
+        uint16_t info[2] = { }; // bytes used, bit count
+        trk_offsets[i] = 256 + i * WOZ1_TRK_SIZE;
+        if (used[i] && read_at(trk_offsets[i] + WOZ1_TRACK_LEN, info, sizeof(info)))
         {
-            size_t s = trks[i].block_count * 512;
-#ifdef ESP_PLATFORM
-            trk_ptrs[i] = (uint8_t *)heap_caps_malloc(s, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
-#else
-            trk_ptrs[i] = (uint8_t *)malloc(s);
-#endif
-            if (trk_ptrs[i] != nullptr)
-            {
-                Debug_printf("\nStoring %d bytes of track %d into location %lu", bytes_used, i, trk_ptrs[i]);
-                memset(trk_ptrs[i],0,s);
-                memcpy(trk_ptrs[i], temp_ptr, bytes_used);
-            }
-            else
-            {
-                Debug_printf("\nNo RAM allocated!");
-                free(temp_ptr);
-                return true;
-            }
+            Debug_printf("\nError reading info of track %d", i);
+            return true;
         }
-        else
-        {
-            trk_ptrs[i] = nullptr;
+        if (info[0] > WOZ1_TRACK_LEN)
+            info[0] = WOZ1_TRACK_LEN;
+        trk_bytes_used[i] = info[0];
+        trks[i].start_block = 0;
+        trks[i].block_count = (info[1] > 0) ? (info[0] + 511) / 512 : 0;
+        trks[i].bit_count = info[1];
+        if (used[i] && info[1] == 0)
             Debug_printf("\nTrack %d is blank!",i);
-        }
-        _media_fileh->read(temp_ptr, 1, 6); // read through rest of bytes in track
     }
-    free(temp_ptr);
     return false;
 }
 
 bool MediaTypeWOZ::woz2_read_tracks()
 {    // depend upon little endian-ness
-    _media_fileh->seek(256, SEEK_SET);
-    _media_fileh->read(&trks, sizeof(TRK_t), MAX_TRACKS);
+    if (read_at(256, &trks, sizeof(trks)))
+    {
+        Debug_printf("\nError reading TRKS chunk");
+        return true;
+    }
 #ifdef DEBUG
     Debug_printf("\nStart Block, Block Count, Bit Count");
     for (int i=0; i<MAX_TRACKS; i++)
         Debug_printf("\n%d, %d, %lu", trks[i].start_block, trks[i].block_count, trks[i].bit_count);
 #endif
-    // read WOZ tracks into RAM
     for (int i=0; i<MAX_TRACKS; i++)
-    {
-        size_t s = trks[i].block_count * 512;
-        if (s != 0)
-        {
-#ifdef ESP_PLATFORM
-            trk_ptrs[i] = (uint8_t *)heap_caps_malloc(s, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
-#else
-            trk_ptrs[i] = (uint8_t *)malloc(s);
-#endif
-            if (trk_ptrs[i] != nullptr)
-            {
-                Debug_printf("\nReading %d bytes of track %d into location %lu", s, i, trk_ptrs[i]);
-                _media_fileh->seek(trks[i].start_block * 512, SEEK_SET);
-                _media_fileh->read(trk_ptrs[i], 1, s);
-                Debug_printf("\n%d, %d, %lu", trks[i].start_block, trks[i].block_count, trks[i].bit_count);
-            }
-            else
-            {
-                Debug_printf("\nNo RAM allocated!");
-                return true;
-            }
-        }
-    }
+        trk_offsets[i] = trks[i].start_block * 512;
     return false;
 }
 
@@ -9,6 +9,8 @@
 #define WOZ1_TRACK_LEN 6646
 #define WOZ1_NUM_BLKS 13
 #define WOZ1_BIT_TIME 32
+#define WOZ1_TRK_SIZE 6656 // track data and its info in TRKS chunk
+#define WOZ_TRACK_CACHE_TRACKS 8 // tracks kept in RAM for images which can't be mapped
 struct TRK_t
 {
     uint16_t start_block;
@@ -17,6 +19,8 @@ struct TRK_t
 };
 
 
+// Disk II media, used by disk2.cpp which isn't built with SMARTPORT == SLIP
+// fujinet-pc builds run it only from benchmark "woz"
 class MediaTypeWOZ : public MediaType
 {
 private:
@@ -28,6 +32,19 @@ private:
     bool woz1_read_tracks();
     bool woz2_read_tracks();
 
+    // local WOZ2 image is mapped and tracks point into it, otherwise tracks are read on first use
+    uint8_t *woz_map = nullptr;
+    size_t woz_map_size = 0;
+    bool trk_mapped = false;
+    uint32_t trk_offsets[MAX_TRACKS];
+    uint16_t trk_bytes_used[MAX_TRACKS] = { }; // WOZ1 bitstream, rest of track buffer is zeroed
+    uint32_t trk_lru[MAX_TRACKS] = { };
+    uint32_t lru_clock = 0;
+    int loaded_tracks = 0;
+
+    bool read_at(uint32_t offset, void *buffer, size_t len);
+    bool load_track(uint8_t i);
+
 protected:
     uint8_t tmap[MAX_TRACKS];
     TRK_t trks[MAX_TRACKS];
@@ -45,7 +62,7 @@ public:
     virtual bool status() override {return (_media_fileh != nullptr);}
 
     uint8_t trackmap(uint8_t t) { return tmap[t]; };
-    uint8_t *get_track(int t) { return trk_ptrs[tmap[t]]; };
+    uint8_t *get_track(int t);
     int track_len(int t) { return trks[tmap[t]].block_count * 512; };
     int num_bits(int t) { return trks[tmap[t]].bit_count; };
     uint8_t optimal_bit_timing;
@@ -0,0 +1,135 @@
+#ifdef BUILD_APPLE
+
+#include "trackCache.h"
+
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include "../../include/debug.h"
+
+#define NO_SLOT ((size_t)-1)
+
+TrackCache::TrackCache(size_t num_slots) : _num_slots(num_slots > 0 ? num_slots : 1)
+{
+#ifdef ESP_PLATFORM
+    _data = (uint8_t *)heap_caps_malloc(_num_slots * TRACK_CACHE_BYTES_PER_TRACK, MALLOC_CAP_8BIT | MALLOC_CAP_SPIRAM);
+#else
+    _data = (uint8_t *)malloc(_num_slots * TRACK_CACHE_BYTES_PER_TRACK);
+#endif
+    _slots = new track_slot[_num_slots];
+    detach();
+}
+
+TrackCache::~TrackCache()
+{
+    free(_data);
+    delete[] _slots;
+}
+
+void TrackCache::attach(FileHandler *f, uint32_t num_tracks)
+{
+    detach();
+    _fileh = f;
+    _num_tracks = num_tracks;
+}
+
+void TrackCache::detach()
+{
+    _fileh = nullptr;
+    _num_tracks = 0;
+    _use_counter = 0;
+    for (size_t i = 0; i < _num_slots; i++)
+        _slots[i].valid = false;
+}
+
+size_t TrackCache::find_slot(uint32_t track)
+{
+    for (size_t i = 0; i < _num_slots; i++)
+    {
+        if (_slots[i].valid && _slots[i].track == track)
+            return i;
+    }
+    return NO_SLOT;
+}
+
+// empty slot, or least recently used one
+size_t TrackCache::free_slot()
+{
+    size_t lru = 0;
+    for (size_t i = 0; i < _num_slots; i++)
+    {
+        if (!_slots[i].valid)
+            return i;
+        if (_slots[i].last_use < _slots[lru].last_use)
+            lru = i;
+    }
+    return lru;
+}
+
+uint8_t *TrackCache::track(uint32_t track)
+{
+    if (_fileh == nullptr || _data == nullptr || track >= _num_tracks)
+        return nullptr;
+
+    size_t slot = find_slot(track);
+    if (slot == NO_SLOT)
+    {
+        Debug_printf("\r\nTrackCache read track %" PRIu32, track);
+        slot = free_slot();
+        _slots[slot].valid = false;
+        uint8_t *dest = _data + slot * TRACK_CACHE_BYTES_PER_TRACK;
+        if (_fileh->seek(track * TRACK_CACHE_BYTES_PER_TRACK, SEEK_SET) != 0)
+            return nullptr;
+        if (_fileh->read(dest, 1, TRACK_CACHE_BYTES_PER_TRACK) != TRACK_CACHE_BYTES_PER_TRACK)
+            return nullptr;
+        _slots[slot].track = track;
+        _slots[slot].valid = true;
+    }
+    _slots[slot].last_use = ++_use_counter;
+    return _data + slot * TRACK_CACHE_BYTES_PER_TRACK;
+}
+
+bool TrackCache::preload(uint32_t first, uint32_t count)
+{
+    if (_fileh == nullptr || _data == nullptr || count > _num_slots || first + count > _num_tracks)
+        return true;
+
+    for (size_t i = 0; i < _num_slots; i++)
+        _slots[i].valid = false;
+
+    const size_t size = count * TRACK_CACHE_BYTES_PER_TRACK;
+    if (_fileh->seek(first * TRACK_CACHE_BYTES_PER_TRACK, SEEK_SET) != 0)
+        return true;
+    if (_fileh->read(_data, 1, size) != size)
+        return true;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        _slots[i].track = first + i;
+        _slots[i].last_use = ++_use_counter;
+        _slots[i].valid = true;
+    }
+    return false;
+}
+
+bool TrackCache::write(uint32_t track, uint32_t offset, const uint8_t *data, size_t len)
+{
+    if (_fileh == nullptr || track >= _num_tracks || offset + len > TRACK_CACHE_BYTES_PER_TRACK)
+        return true;
+
+    size_t slot = find_slot(track);
+    if (_fileh->seek(track * TRACK_CACHE_BYTES_PER_TRACK + offset, SEEK_SET) != 0 ||
+        _fileh->write(data, 1, len) != len)
+    {
+        // image content unknown now, read it again next time
+        if (slot != NO_SLOT)
+            _slots[slot].valid = false;
+        return true;
+    }
+
+    if (slot != NO_SLOT)
+        memcpy(_data + slot * TRACK_CACHE_BYTES_PER_TRACK + offset, data, len);
+    return false;
+}
+
+#endif // BUILD_APPLE
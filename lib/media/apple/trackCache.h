@@ -0,0 +1,55 @@
+#ifndef _TRACK_CACHE_
+#define _TRACK_CACHE_
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "fnFile.h"
+
+#define TRACK_CACHE_BYTES_PER_TRACK 4096 // 16 sectors of 256 bytes
+#define TRACK_CACHE_TRACKS 40            // default, largest supported 5.25" image (160 KB) fits
+
+// Cache of whole 5.25" tracks of DOS/ProDOS ordered images (.DO, .DSK)
+// A track is read from the image with a single read, sectors and blocks are
+// then taken from memory. Least recently used track is evicted.
+// Writes go to the image right away (write-through), cached track is updated.
+class TrackCache
+{
+private:
+    struct track_slot
+    {
+        uint32_t track;
+        uint32_t last_use;
+        bool valid;
+    };
+
+    FileHandler *_fileh = nullptr; // not owned
+    uint32_t _num_tracks = 0;
+    size_t _num_slots;
+    uint8_t *_data = nullptr;      // _num_slots tracks
+    track_slot *_slots = nullptr;
+    uint32_t _use_counter = 0;
+
+    size_t find_slot(uint32_t track);
+    size_t free_slot();
+
+public:
+    TrackCache(size_t num_slots = TRACK_CACHE_TRACKS);
+    ~TrackCache();
+
+    // start caching image in f, previously cached tracks are dropped
+    void attach(FileHandler *f, uint32_t num_tracks);
+    // drop all cached tracks and forget image
+    void detach();
+
+    // Returns pointer to whole track data, nullptr on error
+    uint8_t *track(uint32_t track);
+    // Loads count tracks starting with first using one read, count must not exceed number of slots
+    // Returns TRUE if an error condition occurred
+    bool preload(uint32_t first, uint32_t count);
+    // Writes len bytes at offset within track to image and cached track
+    // Returns TRUE if an error condition occurred
+    bool write(uint32_t track, uint32_t offset, const uint8_t *data, size_t len);
+};
+
+#endif // _TRACK_CACHE_
@@ -11,6 +11,7 @@
 
 #include "disk.h"
 #include "fnSystem.h"
+#include "fnConfig.h"
 
 #include "utils.h"
 
@@ -51,6 +52,110 @@ uint32_t MediaTypeATR::_sector_to_offset(uint16_t sectorNum)
     return offset;
 }
 
+// Returns slot holding sectornum, nullptr if it isn't cached
+MediaTypeATR::cache_slot *MediaTypeATR::_cache_find(uint16_t sectornum)
+{
+    for (int i = 0; i < ATR_CACHE_SLOTS; i++)
+    {
+        cache_slot &slot = _cache[i];
+        if (slot.first != 0 && sectornum >= slot.first && sectornum < slot.first + slot.count)
+        {
+            slot.last_used = ++_cache_clock;
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+// Reads sectors from sectornum on into least recently used slot with one seek and read
+// Read-ahead starts at ATR_CACHE_RANDOM_BYTES and doubles with every miss which continues
+// sequential reading, up to the read_ahead config setting or a whole track
+// Returns nullptr if sectornum couldn't be read
+MediaTypeATR::cache_slot *MediaTypeATR::_cache_fill(uint16_t sectornum)
+{
+    if (sectornum == 0)
+        return nullptr;
+
+    uint32_t track = _cache_window;
+    if (track == 0)
+        track = UINT16_FROM_HILOBYTES(_percomBlock.sectors_per_trackH, _percomBlock.sectors_per_trackL);
+    if (track == 0 || track > ATR_CACHE_WINDOW_MAX)
+        track = ATR_CACHE_WINDOW_MAX;
+
+    uint32_t window = ATR_CACHE_RANDOM_BYTES / sector_size(sectornum);
+    if (sectornum == _disk_last_sector + 1 && _cache_ahead * 2 > window)
+        window = _cache_ahead * 2;
+    if (window > track)
+        window = track;
+    if (window == 0)
+        window = 1;
+    _cache_ahead = window;
+
+    uint16_t first = sectornum;
+    uint32_t last = first + window - 1;
+    if (last > _disk_num_sectors)
+        last = _disk_num_sectors;
+
+    cache_slot *slot = &_cache[0];
+    for (int i = 1; i < ATR_CACHE_SLOTS; i++)
+        if (_cache[i].last_used < slot->last_used)
+            slot = &_cache[i];
+
+    uint32_t offset = _sector_to_offset(first);
+    size_t len = _sector_to_offset(last) + sector_size(last) - offset;
+    slot->first = 0;
+    if (slot->size < len)
+    {
+        // PERCOM block may have changed geometry
+        free(slot->data);
+        slot->data = (uint8_t *)malloc(len);
+        slot->size = (slot->data != nullptr) ? len : 0;
+        if (slot->data == nullptr)
+            return nullptr;
+    }
+
+    if (first != _disk_last_sector + 1 && _disk_fileh->seek(offset, SEEK_SET) != 0)
+    {
+        _disk_last_sector = INVALID_SECTOR_VALUE;
+        return nullptr;
+    }
+    size_t got = _disk_fileh->read(slot->data, 1, len);
+
+    // keep sectors which were read completely, image may be truncated
+    uint32_t count = 0;
+    while (first + count <= last && _sector_to_offset(first + count) + sector_size(first + count) - offset <= got)
+        count++;
+    if (count == 0 || sectornum >= first + count)
+    {
+        _disk_last_sector = INVALID_SECTOR_VALUE;
+        return nullptr;
+    }
+    _disk_last_sector = (got == len) ? last : INVALID_SECTOR_VALUE;
+
+    Debug_printf("ATR cache %d..%d\r\n", first, first + count - 1);
+    slot->first = first;
+    slot->count = count;
+    slot->last_used = ++_cache_clock;
+    return slot;
+}
+
+void MediaTypeATR::_cache_invalidate(bool release)
+{
+    _cache_ahead = 0;
+    for (int i = 0; i < ATR_CACHE_SLOTS; i++)
+    {
+        _cache[i].first = 0;
+        _cache[i].count = 0;
+        _cache[i].last_used = 0;
+        if (release && _cache[i].data != nullptr)
+        {
+            free(_cache[i].data);
+            _cache[i].data = nullptr;
+            _cache[i].size = 0;
+        }
+    }
+}
+
 // Returns TRUE if an error condition occurred
 bool MediaTypeATR::read(uint16_t sectornum, uint16_t *readcount)
 {
@@ -69,21 +174,14 @@ bool MediaTypeATR::read(uint16_t sectornum, uint16_t *readcount)
 
     memset(_disk_sectorbuff, 0, sizeof(_disk_sectorbuff));
 
-    bool err = false;
-    // Perform a seek if we're not reading the sector after the last one we read
-    if (sectornum != _disk_last_sector + 1)
-    {
-        uint32_t offset = _sector_to_offset(sectornum);
-        err = _disk_fileh->seek(offset, SEEK_SET) != 0;
-    }
+    // Cache hits don't touch the file, misses read ahead
+    cache_slot *slot = _cache_find(sectornum);
+    if (slot == nullptr)
+        slot = _cache_fill(sectornum);
 
+    bool err = slot == nullptr;
     if (err == false)
-        err = _disk_fileh->read(_disk_sectorbuff, 1, sectorSize) != sectorSize;
-
-    if (err == false)
-        _disk_last_sector = sectornum;
-    else
-        _disk_last_sector = INVALID_SECTOR_VALUE;
+        memcpy(_disk_sectorbuff, slot->data + _sector_to_offset(sectornum) - _sector_to_offset(slot->first), sectorSize);
 
     *readcount = sectorSize;
 
@@ -147,12 +245,22 @@ bool MediaTypeATR::write(uint16_t sectornum, bool verify)
     if (e != sectorSize)
     {
         Debug_printf("::write error %d, %d\r\n", e, errno);
+        // sector may be partially written
+        _cache_invalidate();
         return true;
     }
 
     int ret = _disk_fileh->flush();
     Debug_printf("ATR::write fsync:%d\n", ret);
 
+    // Keep cached copies in sync, windows may overlap
+    for (int i = 0; i < ATR_CACHE_SLOTS; i++)
+    {
+        cache_slot &slot = _cache[i];
+        if (slot.first != 0 && sectornum >= slot.first && sectornum < slot.first + slot.count)
+            memcpy(slot.data + offset - _sector_to_offset(slot.first), _disk_sectorbuff, sectorSize);
+    }
+
     if (_high_score_sector != 0)
     {
         Debug_printf("Closing high score sector.\r\n");
@@ -196,6 +304,8 @@ bool MediaTypeATR::format(uint16_t *responsesize)
 {
     Debug_print("ATR FORMAT\r\n");
 
+    _cache_invalidate();
+
     // Populate an empty bad sector map
     memset(_disk_sectorbuff, 0, sizeof(_disk_sectorbuff));
     _disk_sectorbuff[0] = 0xFF;
@@ -265,6 +375,8 @@ mediatype_t MediaTypeATR::mount(FileHandler *f, uint32_t disksize)
     _disk_fileh = f;
     _disk_image_size = disksize;
     _disk_last_sector = INVALID_SECTOR_VALUE;
+    _cache_invalidate(true);
+    _cache_window = Config.get_general_read_ahead();
 
     _high_score_sector = UINT16_FROM_HILOBYTES(buf[14], buf[13]);
     _high_score_num_sectors = buf[12] - 1;
@@ -280,6 +392,18 @@ mediatype_t MediaTypeATR::mount(FileHandler *f, uint32_t disksize)
     return _disktype;
 }
 
+void MediaTypeATR::unmount()
+{
+    _cache_invalidate(true);
+    // Call the parent unmount
+    MediaType::unmount();
+}
+
+MediaTypeATR::~MediaTypeATR()
+{
+    unmount();
+}
+
 // Returns FALSE on error
 bool MediaTypeATR::create(FileHandler *f, uint16_t sectorSize, uint16_t numSectors)
 {
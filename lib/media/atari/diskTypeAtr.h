@@ -3,11 +3,33 @@
 
 #include "diskType.h"
 
+#define ATR_CACHE_SLOTS 16          // read-ahead windows kept per disk
+#define ATR_CACHE_WINDOW_MAX 36     // limit for images which are one long track
+#define ATR_CACHE_RANDOM_BYTES 512  // read ahead by random reads, one TNFS READ
+
 class MediaTypeATR : public MediaType
 {
 private:
+    // sectors first .. first + count - 1, read with one seek and read
+    struct cache_slot
+    {
+        uint16_t first = 0; // 0 = unused
+        uint16_t count = 0;
+        uint32_t last_used = 0;
+        uint8_t *data = nullptr;
+        size_t size = 0;
+    };
+    cache_slot _cache[ATR_CACHE_SLOTS];
+    uint32_t _cache_clock = 0;
+    uint32_t _cache_ahead = 0; // sectors read by last miss
+    uint32_t _cache_window = 0; // max. sectors read ahead by sequential reads, 0 = whole track (18 or 26 sectors)
+
     uint32_t _sector_to_offset(uint16_t sectorNum);
 
+    cache_slot *_cache_find(uint16_t sectornum);
+    cache_slot *_cache_fill(uint16_t sectornum);
+    void _cache_invalidate(bool release = false);
+
 public:
     virtual bool read(uint16_t sectornum, uint16_t *readcount) override;
     virtual bool write(uint16_t sectornum, bool verify) override;
@@ -15,10 +37,13 @@ public:
     virtual bool format(uint16_t *respopnsesize) override;
 
     virtual mediatype_t mount(FileHandler *f, uint32_t disksize) override;
+    virtual void unmount() override;
 
     virtual void status(uint8_t statusbuff[4]) override;
 
     static bool create(FileHandler *f, uint16_t sectorSize, uint16_t numSectors);
+
+    ~MediaTypeATR();
 };
 
 
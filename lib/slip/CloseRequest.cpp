@@ -6,7 +6,7 @@
 
 
 CloseRequest::CloseRequest(const uint8_t request_sequence_number, const uint8_t sp_unit)
-	: Request(request_sequence_number, SP_CLOSE, sp_unit) {}
+	: Request(request_sequence_number, SP_CLOSE, sp_unit), response_(request_sequence_number, 0) {}
 
 std::vector<uint8_t> CloseRequest::serialize() const
 {
@@ -33,8 +33,8 @@ void CloseRequest::create_command(uint8_t* cmd_data) const
 	init_command(cmd_data);
 }
 
-std::unique_ptr<Response> CloseRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* CloseRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-    std::unique_ptr<CloseResponse> response = std::make_unique<CloseResponse>(get_request_sequence_number(), status);
-    return response;
+	response_.reset(get_request_sequence_number(), status);
+	return &response_;
 }
\ No newline at end of file
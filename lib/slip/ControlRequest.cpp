@@ -6,7 +6,7 @@
 
 
 ControlRequest::ControlRequest(const uint8_t request_sequence_number, const uint8_t sp_unit, const uint8_t control_code, std::vector<uint8_t>& data)
-	: Request(request_sequence_number, SP_CONTROL, sp_unit), control_code_(control_code), data_(std::move(data)) {}
+	: Request(request_sequence_number, SP_CONTROL, sp_unit), control_code_(control_code), data_(std::move(data)), response_(request_sequence_number, 0) {}
 
 std::vector<uint8_t> ControlRequest::serialize() const
 {
@@ -37,6 +37,11 @@ void ControlRequest::create_command(uint8_t* cmd_data) const
 	cmd_data[4] = control_code_;
 }
 
+void ControlRequest::set_data_from_ptr(const uint8_t* ptr, const size_t offset, const size_t length)
+{
+	data_.assign(ptr + offset, ptr + offset + length);
+}
+
 void ControlRequest::copy_payload(uint8_t* data) const {
 	std::copy(data_.begin(), data_.end(), data);
 }
@@ -45,8 +50,8 @@ size_t ControlRequest::payload_size() const {
 	return data_.size();
 }
 
-std::unique_ptr<Response> ControlRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* ControlRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-    std::unique_ptr<ControlResponse> response = std::make_unique<ControlResponse>(get_request_sequence_number(), status);
-    return response;
+	response_.reset(get_request_sequence_number(), status);
+	return &response_;
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include "Request.h"
 #include "Response.h"
+#include "ControlResponse.h"
 
 class ControlRequest : public Request
 {
@@ -15,12 +16,17 @@ public:
 
 	const std::vector<uint8_t>& get_data() const { return data_; }
 	uint8_t get_control_code() const { return control_code_; }
+	void set_control_code(const uint8_t control_code) { control_code_ = control_code; }
+	void set_data_from_ptr(const uint8_t* ptr, size_t offset, size_t length);
 	void create_command(uint8_t* output_data) const override;
 	void copy_payload(uint8_t* data) const override;
 	size_t payload_size() const override;
-	std::unique_ptr<Response> create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const override;
+	Response* create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) override;
 
 private:
 	uint8_t control_code_;
 	std::vector<uint8_t> data_;
+
+	// reused for every response to this request
+	ControlResponse response_;
 };
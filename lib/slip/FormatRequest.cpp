@@ -5,7 +5,7 @@
 
 
 FormatRequest::FormatRequest(const uint8_t request_sequence_number, const uint8_t sp_unit)
-	: Request(request_sequence_number, SP_FORMAT, sp_unit) {}
+	: Request(request_sequence_number, SP_FORMAT, sp_unit), response_(request_sequence_number, 0) {}
 
 std::vector<uint8_t> FormatRequest::serialize() const
 {
@@ -32,8 +32,8 @@ void FormatRequest::create_command(uint8_t* cmd_data) const
 	init_command(cmd_data);
 }
 
-std::unique_ptr<Response> FormatRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* FormatRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-    std::unique_ptr<FormatResponse> response = std::make_unique<FormatResponse>(get_request_sequence_number(), status);
-    return response;
+	response_.reset(get_request_sequence_number(), status);
+	return &response_;
 }
\ No newline at end of file
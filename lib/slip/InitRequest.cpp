@@ -5,7 +5,7 @@
 
 
 InitRequest::InitRequest(const uint8_t request_sequence_number, const uint8_t sp_unit)
-	: Request(request_sequence_number, SP_INIT, sp_unit) {}
+	: Request(request_sequence_number, SP_INIT, sp_unit), response_(request_sequence_number, 0) {}
 
 std::vector<uint8_t> InitRequest::serialize() const
 {
@@ -32,8 +32,8 @@ void InitRequest::create_command(uint8_t* cmd_data) const
 	init_command(cmd_data);
 }
 
-std::unique_ptr<Response> InitRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* InitRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-    std::unique_ptr<InitResponse> response = std::make_unique<InitResponse>(get_request_sequence_number(), status);
-    return response;
+	response_.reset(get_request_sequence_number(), status);
+	return &response_;
 }
\ No newline at end of file
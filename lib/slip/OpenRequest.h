@@ -5,6 +5,7 @@
 
 #include "Request.h"
 #include "Response.h"
+#include "OpenResponse.h"
 
 class OpenRequest : public Request
 {
@@ -15,5 +16,9 @@ public:
 	void create_command(uint8_t* output_data) const override;
 	void copy_payload(uint8_t* data) const override {}
 	size_t payload_size() const override { return 0; };
-	std::unique_ptr<Response> create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const override;
+	Response* create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) override;
+
+private:
+	// reused for every response to this request
+	OpenResponse response_;
 };
@@ -1,11 +1,12 @@
-﻿#include "ReadBlockRequest.h"
+﻿#include <algorithm>
+#include "ReadBlockRequest.h"
 
 #include "ReadBlockResponse.h"
 #include "SmartPortCodes.h"
 
 
 ReadBlockRequest::ReadBlockRequest(const uint8_t request_sequence_number, const uint8_t sp_unit)
-	: Request(request_sequence_number, SP_READ_BLOCK, sp_unit), block_number_{} {}
+	: Request(request_sequence_number, SP_READ_BLOCK, sp_unit), block_number_{}, response_(request_sequence_number, 0) {}
 
 std::vector<uint8_t> ReadBlockRequest::serialize() const
 {
@@ -47,13 +48,10 @@ void ReadBlockRequest::create_command(uint8_t* cmd_data) const
 	std::copy(block_number_.begin(), block_number_.end(), cmd_data + 4);
 }
 
-std::unique_ptr<Response> ReadBlockRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* ReadBlockRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-    std::unique_ptr<ReadBlockResponse> response = std::make_unique<ReadBlockResponse>(get_request_sequence_number(), status);
-		// Copy the return data if the status is OK
-		if (status == 0) {
-			std::vector<uint8_t> data_vector(data, data + num);
-			response->set_block_data(data_vector.begin(), data_vector.end());
-		}
-    return response;
+	response_.reset(get_request_sequence_number(), status);
+	// Copy the return data if the status is OK
+	response_.set_block_data_from_ptr(data, status == 0 ? num : 0);
+	return &response_;
 }
\ No newline at end of file
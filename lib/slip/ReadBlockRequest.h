@@ -6,6 +6,7 @@
 
 #include "Request.h"
 #include "Response.h"
+#include "ReadBlockResponse.h"
 
 class ReadBlockRequest : public Request
 {
@@ -18,8 +19,11 @@ public:
 	void create_command(uint8_t* output_data) const override;
 	void copy_payload(uint8_t* data) const override {}
 	size_t payload_size() const override { return 0; };
-	std::unique_ptr<Response> create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const override;
+	Response* create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) override;
 
 private:
 	std::array<uint8_t, 3> block_number_;
+
+	// reused for every response to this request
+	ReadBlockResponse response_;
 };
@@ -19,6 +19,13 @@ void ReadBlockResponse::set_block_data(std::vector<uint8_t>::const_iterator begi
 	std::copy(begin, end, block_data_.begin()); // NOLINT(performance-unnecessary-value-param)
 }
 
+void ReadBlockResponse::set_block_data_from_ptr(const uint8_t* ptr, size_t length)
+{
+	length = std::min(length, block_data_.size());
+	std::copy_n(ptr, length, block_data_.begin());
+	std::fill(block_data_.begin() + length, block_data_.end(), 0);
+}
+
 const std::array<uint8_t, 512>& ReadBlockResponse::get_block_data() const
 {
 	return block_data_;
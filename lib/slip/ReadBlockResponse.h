@@ -10,6 +10,11 @@ public:
 
 	void set_block_data(std::vector<uint8_t>::const_iterator begin, std::vector<uint8_t>::const_iterator end);
 	const std::array<uint8_t, 512>& get_block_data() const;
+	// copies up to 512 bytes, rest of the block is zeroed
+	void set_block_data_from_ptr(const uint8_t* ptr, size_t length);
+
+	const uint8_t* get_payload() const override { return block_data_.data(); }
+	size_t get_payload_size() const override { return block_data_.size(); }
 
 private:
 	std::array<uint8_t, 512> block_data_;
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <stdexcept>
+#include "ReadBlocksRequest.h"
+
+#include "SmartPortCodes.h"
+
+
+ReadBlocksRequest::ReadBlocksRequest(const uint8_t request_sequence_number, const uint8_t sp_unit)
+	: Request(request_sequence_number, SP_READ_BLOCKS, sp_unit), block_number_{}, response_(request_sequence_number, 0) {}
+
+std::vector<uint8_t> ReadBlocksRequest::serialize() const
+{
+	std::vector<uint8_t> request_data;
+	request_data.push_back(this->get_request_sequence_number());
+	request_data.push_back(this->get_command_number());
+	request_data.push_back(this->get_sp_unit());
+	request_data.insert(request_data.end(), block_number_.begin(), block_number_.end());
+	request_data.push_back(block_count_);
+	return request_data;
+}
+
+std::unique_ptr<Response> ReadBlocksRequest::deserialize(const std::vector<uint8_t>& data) const
+{
+	if (data.size() < 2)
+	{
+		throw std::runtime_error("Not enough data to deserialize ReadBlocksResponse");
+	}
+
+	auto response = std::make_unique<ReadBlocksResponse>(data[0], data[1]);
+	if (response->get_status() == 0)
+	{
+		response->set_data_from_ptr(data.data() + 2, data.size() - 2);
+	}
+	return response;
+}
+
+const std::array<uint8_t, 3>& ReadBlocksRequest::get_block_number() const
+{
+	return block_number_;
+}
+
+void ReadBlocksRequest::set_block_number_from_ptr(const uint8_t* ptr, const size_t offset) {
+	std::copy_n(ptr + offset, block_number_.size(), block_number_.begin());
+}
+
+void ReadBlocksRequest::create_command(uint8_t* cmd_data) const
+{
+	init_command(cmd_data);
+	std::copy(block_number_.begin(), block_number_.end(), cmd_data + 4);
+	cmd_data[7] = block_count_;
+}
+
+Response* ReadBlocksRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
+{
+	response_.reset(get_request_sequence_number(), status);
+	// Copy the return data if the status is OK
+	response_.set_data_from_ptr(data, status == 0 ? num : 0);
+	return &response_;
+}
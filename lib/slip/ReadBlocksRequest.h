@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <array>
+
+#include "Request.h"
+#include "Response.h"
+#include "ReadBlocksResponse.h"
+
+// SP_READ_BLOCKS extension, reads count consecutive blocks with one request
+class ReadBlocksRequest : public Request
+{
+public:
+	ReadBlocksRequest(uint8_t request_sequence_number, uint8_t sp_unit);
+	std::vector<uint8_t> serialize() const override;
+	std::unique_ptr<Response> deserialize(const std::vector<uint8_t>& data) const override;
+	const std::array<uint8_t, 3>& get_block_number() const;
+	void set_block_number_from_ptr(const uint8_t* ptr, size_t offset);
+	uint8_t get_block_count() const { return block_count_; }
+	void set_block_count(const uint8_t block_count) { block_count_ = block_count; }
+	void create_command(uint8_t* output_data) const override;
+	void copy_payload(uint8_t* data) const override {}
+	size_t payload_size() const override { return 0; };
+	Response* create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) override;
+
+private:
+	std::array<uint8_t, 3> block_number_;
+	uint8_t block_count_ = 0;
+
+	// reused for every response to this request
+	ReadBlocksResponse response_;
+};
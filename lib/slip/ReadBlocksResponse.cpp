@@ -0,0 +1,15 @@
+#include "ReadBlocksResponse.h"
+
+ReadBlocksResponse::ReadBlocksResponse(const uint8_t request_sequence_number, const uint8_t status) : Response(request_sequence_number, status) {}
+
+std::vector<uint8_t> ReadBlocksResponse::serialize() const
+{
+	std::vector<uint8_t> data;
+	serialize_to(data);
+	return data;
+}
+
+void ReadBlocksResponse::set_data_from_ptr(const uint8_t* ptr, const size_t length)
+{
+	data_.assign(ptr, ptr + length);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+#include <stdint.h>
+#include "Response.h"
+
+class ReadBlocksResponse : public Response
+{
+public:
+	explicit ReadBlocksResponse(uint8_t request_sequence_number, uint8_t status);
+	std::vector<uint8_t> serialize() const override;
+
+	const std::vector<uint8_t>& get_data() const { return data_; }
+	void set_data_from_ptr(const uint8_t* ptr, size_t length);
+
+	const uint8_t* get_payload() const override { return data_.data(); }
+	size_t get_payload_size() const override { return data_.size(); }
+
+private:
+	// count * 512 bytes, capacity is kept between responses
+	std::vector<uint8_t> data_;
+};
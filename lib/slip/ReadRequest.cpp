@@ -1,11 +1,12 @@
-﻿#include "ReadRequest.h"
+﻿#include <algorithm>
+#include "ReadRequest.h"
 
 #include "ReadResponse.h"
 #include "SmartPortCodes.h"
 
 
 ReadRequest::ReadRequest(const uint8_t request_sequence_number, const uint8_t sp_unit)
-	: Request(request_sequence_number, SP_READ, sp_unit), byte_count_(), address_()
+	: Request(request_sequence_number, SP_READ, sp_unit), byte_count_(), address_(), response_(request_sequence_number, 0)
 {
 }
 
@@ -60,13 +61,10 @@ void ReadRequest::create_command(uint8_t* cmd_data) const
 	std::copy(address_.begin(), address_.end(), cmd_data + 6);
 }
 
-std::unique_ptr<Response> ReadRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* ReadRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-    std::unique_ptr<ReadResponse> response = std::make_unique<ReadResponse>(get_request_sequence_number(), status);
-		// Copy the return data if the status is OK
-		if (status == 0) {
-			std::vector<uint8_t> data_vector(data, data + num);
-			response->set_data(data_vector.begin(), data_vector.end());
-		}
-    return response;
+	response_.reset(get_request_sequence_number(), status);
+	// Copy the return data if the status is OK
+	response_.set_data_from_ptr(data, status == 0 ? num : 0);
+	return &response_;
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 // ReSharper disable CppPassValueParameterByConstReference
+#include <algorithm>
+
 #include "ReadResponse.h"
 
 ReadResponse::ReadResponse(const uint8_t request_sequence_number, const uint8_t status) : Response(request_sequence_number, status) {}
@@ -17,4 +19,9 @@ void ReadResponse::set_data(const std::vector<uint8_t>::const_iterator& begin, c
 	const size_t new_size = std::distance(begin, end);
 	data_.resize(new_size);
 	std::copy(begin, end, data_.begin()); // NOLINT(performance-unnecessary-value-param)
+}
+
+void ReadResponse::set_data_from_ptr(const uint8_t* ptr, const size_t length)
+{
+	data_.assign(ptr, ptr + length);
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include <sstream>
+#include <stdexcept>
+
+#include "RequestPool.h"
+#include "SmartPortCodes.h"
+
+namespace
+{
+	std::vector<uint8_t> no_data;
+}
+
+RequestPool::RequestPool()
+	: close_(0, 0), control_(0, 0, 0, no_data), format_(0, 0), init_(0, 0), open_(0, 0), read_block_(0, 0),
+	  read_blocks_(0, 0), read_(0, 0), reset_(0, 0), status_(0, 0, 0), write_block_(0, 0), write_(0, 0) {}
+
+Request* RequestPool::from_packet(const std::vector<uint8_t>& packet)
+{
+	const uint8_t command = packet[1];
+	switch (command)
+	{
+	case SP_STATUS:
+		status_.reset(packet[0], packet[2]);
+		status_.set_status_code(packet[3]);
+		return &status_;
+
+	case SP_CONTROL:
+		control_.reset(packet[0], packet[2]);
+		control_.set_control_code(packet[3]);
+		// +6 = 3 for "header", 1 for control code, 2 for length bytes we need to skip
+		control_.set_data_from_ptr(packet.data(), 6, packet.size() - 6);
+		return &control_;
+
+	case SP_READ_BLOCK:
+		read_block_.reset(packet[0], packet[2]);
+		read_block_.set_block_number_from_ptr(packet.data(), 3);
+		return &read_block_;
+
+	case SP_READ_BLOCKS:
+		read_blocks_.reset(packet[0], packet[2]);
+		read_blocks_.set_block_number_from_ptr(packet.data(), 3);
+		read_blocks_.set_block_count(packet[6]);
+		return &read_blocks_;
+
+	case SP_WRITE_BLOCK:
+		write_block_.reset(packet[0], packet[2]);
+		write_block_.set_block_number_from_ptr(packet.data(), 3);
+		write_block_.set_block_data_from_ptr(packet.data(), 6);
+		return &write_block_;
+
+	case SP_FORMAT:
+		format_.reset(packet[0], packet[2]);
+		return &format_;
+
+	case SP_INIT:
+		init_.reset(packet[0], packet[2]);
+		return &init_;
+
+	case SP_OPEN:
+		open_.reset(packet[0], packet[2]);
+		return &open_;
+
+	case SP_CLOSE:
+		close_.reset(packet[0], packet[2]);
+		return &close_;
+
+	case SP_READ:
+		read_.reset(packet[0], packet[2]);
+		read_.set_byte_count_from_ptr(packet.data(), 3);
+		read_.set_address_from_ptr(packet.data(), 5);
+		return &read_;
+
+	case SP_WRITE:
+		write_.reset(packet[0], packet[2]);
+		write_.set_byte_count_from_ptr(packet.data(), 3);
+		write_.set_address_from_ptr(packet.data(), 5);
+		write_.set_data_from_ptr(packet.data(), 8, packet.size() - 8);
+		return &write_;
+
+	case SP_RESET:
+		reset_.reset(packet[0], packet[2]);
+		return &reset_;
+
+	default:
+	{
+		std::ostringstream oss;
+		oss << "Unknown command: " << static_cast<int>(command);
+		throw std::runtime_error(oss.str());
+	}
+	}
+}
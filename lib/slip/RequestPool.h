@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Request.h"
+#include "CloseRequest.h"
+#include "ControlRequest.h"
+#include "FormatRequest.h"
+#include "InitRequest.h"
+#include "OpenRequest.h"
+#include "ReadBlockRequest.h"
+#include "ReadBlocksRequest.h"
+#include "ReadRequest.h"
+#include "ResetRequest.h"
+#include "StatusRequest.h"
+#include "WriteBlockRequest.h"
+#include "WriteRequest.h"
+
+// Holds one Request object of every type, each with its own Response object.
+// Objects are reused for every packet, so handling a request does not allocate
+// (Control and Write keep the capacity of their data buffers).
+// A Request returned by from_packet is valid until the next from_packet call,
+// the pool is meant for a single consumer handling one request at a time.
+class RequestPool
+{
+public:
+	RequestPool();
+
+	// Fill the Request object of the packet's command from the packet data
+	Request* from_packet(const std::vector<uint8_t>& packet);
+
+private:
+	CloseRequest close_;
+	ControlRequest control_;
+	FormatRequest format_;
+	InitRequest init_;
+	OpenRequest open_;
+	ReadBlockRequest read_block_;
+	ReadBlocksRequest read_blocks_;
+	ReadRequest read_;
+	ResetRequest reset_;
+	StatusRequest status_;
+	WriteBlockRequest write_block_;
+	WriteRequest write_;
+};
@@ -5,7 +5,7 @@
 
 
 ResetRequest::ResetRequest(const uint8_t request_sequence_number, const uint8_t sp_unit)
-	: Request(request_sequence_number, SP_RESET, sp_unit) {}
+	: Request(request_sequence_number, SP_RESET, sp_unit), response_(request_sequence_number, 0) {}
 
 std::vector<uint8_t> ResetRequest::serialize() const
 {
@@ -32,8 +32,8 @@ void ResetRequest::create_command(uint8_t* cmd_data) const
 	init_command(cmd_data);
 }
 
-std::unique_ptr<Response> ResetRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* ResetRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-    std::unique_ptr<ResetResponse> response = std::make_unique<ResetResponse>(get_request_sequence_number(), status);
-    return response;
+	response_.reset(get_request_sequence_number(), status);
+	return &response_;
 }
\ No newline at end of file
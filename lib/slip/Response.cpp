@@ -1,7 +1,27 @@
 
+#include <algorithm>
+
 #include "Response.h"
 
 Response::Response(const uint8_t request_sequence_number, const uint8_t status)
 	: Packet(request_sequence_number), status_(status) {}
 
 uint8_t Response::get_status() const { return status_; }
+
+void Response::reset(const uint8_t request_sequence_number, const uint8_t status)
+{
+	set_request_sequence_number(request_sequence_number);
+	status_ = status;
+}
+
+void Response::serialize_to(std::vector<uint8_t>& out) const
+{
+	const size_t size = get_payload_size();
+	out.resize(2 + size);
+	out[0] = get_request_sequence_number();
+	out[1] = get_status();
+	if (size > 0)
+	{
+		std::copy_n(get_payload(), size, out.begin() + 2);
+	}
+}
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include "Packet.h"
 
 class Response : public Packet
@@ -12,6 +13,16 @@ public:
 
 	uint8_t get_status() const;
 
+	// Response objects are reused, this sets the header of the next response
+	void reset(uint8_t request_sequence_number, uint8_t status);
+
+	// Same data as serialize(), written into out reusing its capacity
+	void serialize_to(std::vector<uint8_t>& out) const;
+
+	// Data following the status byte, implemented by responses which return data
+	virtual const uint8_t* get_payload() const { return nullptr; }
+	virtual size_t get_payload_size() const { return 0; }
+
 private:
 	uint8_t status_ = 0;
 };
\ No newline at end of file
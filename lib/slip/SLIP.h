@@ -2,17 +2,113 @@
 
 #include <vector>
 #include <stdint.h>
+#include <stddef.h>
 
 #define SLIP_END             0300    /* indicates end of packet */
 #define SLIP_ESC             0333    /* indicates byte stuffing */
 #define SLIP_ESC_END         0334    /* ESC ESC_END means END data byte */
 #define SLIP_ESC_ESC         0335    /* ESC ESC_ESC means ESC data byte */
 
+#define SLIP_MAX_PACKET_SIZE 65536   /* larger frames are dropped by SLIPDecoder */
+
 class SLIP
 {
 public:
-	// these encode and decode exactly one SLIP frame, and expect it to be sane.
-	static std::vector<uint8_t> encode(const std::vector<uint8_t>& data);
-	static std::vector<uint8_t> decode(const std::vector<uint8_t>& data);
-	static std::vector<std::vector<uint8_t>> split_into_packets(const uint8_t* data, size_t bytes_read);
+	// Encodes exactly one SLIP frame into out, reusing its capacity.
+	// Returns the encoded size, out may be larger than that.
+	static size_t encode(const uint8_t* data, size_t len, std::vector<uint8_t>& out);
 };
+
+// Incremental SLIP decoder, frames may be split across any number of feed() calls.
+// Decodes into a buffer allocated once, no allocation per packet.
+class SLIPDecoder
+{
+public:
+	explicit SLIPDecoder(size_t max_packet_size = SLIP_MAX_PACKET_SIZE);
+
+	// Decodes data and calls on_packet(const uint8_t* packet, size_t size) for every complete frame.
+	// packet points into decoder buffer and is only valid during the call.
+	template <typename F>
+	void feed(const uint8_t* data, size_t len, F&& on_packet);
+
+	// drop partial frame, wait for next SLIP_END
+	void reset();
+
+private:
+	enum class State
+	{
+		Idle,       // before first SLIP_END
+		Frame,      // collecting frame data
+		Escape,     // after SLIP_ESC
+		Invalid     // bad escape or too long, skip until SLIP_END
+	};
+
+	std::vector<uint8_t> buffer_;
+	size_t size_ = 0;
+	State state_ = State::Idle;
+};
+
+template <typename F>
+void SLIPDecoder::feed(const uint8_t* data, size_t len, F&& on_packet)
+{
+	const size_t max_size = buffer_.size();
+	uint8_t* buffer = buffer_.data();
+
+	for (size_t i = 0; i < len; i++)
+	{
+		uint8_t byte = data[i];
+
+		// SLIP_END finishes current frame and starts next one
+		if (byte == SLIP_END)
+		{
+			if (state_ == State::Frame && size_ > 0)
+			{
+				on_packet(static_cast<const uint8_t*>(buffer), size_);
+			}
+			size_ = 0;
+			state_ = State::Frame;
+			continue;
+		}
+
+		switch (state_)
+		{
+		case State::Idle:
+		case State::Invalid:
+			continue;
+		case State::Frame:
+			if (byte == SLIP_ESC)
+			{
+				state_ = State::Escape;
+				continue;
+			}
+			break;
+		case State::Escape:
+			if (byte == SLIP_ESC_END)
+			{
+				byte = SLIP_END;
+			}
+			else if (byte == SLIP_ESC_ESC)
+			{
+				byte = SLIP_ESC;
+			}
+			else
+			{
+				// Invalid escape sequence
+				state_ = State::Invalid;
+				continue;
+			}
+			state_ = State::Frame;
+			break;
+		}
+
+		if (size_ < max_size)
+		{
+			buffer[size_++] = byte;
+		}
+		else
+		{
+			// Packet too long
+			state_ = State::Invalid;
+		}
+	}
+}
@@ -12,4 +12,5 @@ public:
 	virtual ~SPoSLIP() = default;
 
 	uint8_t get_request_sequence_number() const { return request_sequence_number_; }
+	void set_request_sequence_number(const uint8_t request_sequence_number) { request_sequence_number_ = request_sequence_number; }
 };
@@ -12,5 +12,16 @@ enum
 	SP_CLOSE = 7,
 	SP_READ = 8,
 	SP_WRITE = 9,
-	SP_RESET = 10
+	SP_RESET = 10,
+
+	// FujiNet SmartPort over SLIP extensions. A peer must check the capability
+	// with SP_STATUS_SLIP_CAPS first and fall back to the classic commands.
+	SP_READ_BLOCKS = 0x21	// [block number (3), count (1)], response has count * 512 bytes
 };
+
+// Status code of the extension capabilities. Reply has 2 bytes: [SLIP_CAP_* bits, max blocks per SP_READ_BLOCKS].
+// Devices without the extensions reply with other length or an error.
+#define SP_STATUS_SLIP_CAPS  0x30
+
+#define SLIP_CAP_READ_BLOCKS 0x01
+#define SLIP_READ_BLOCKS_MAX 64  // 32 KB response
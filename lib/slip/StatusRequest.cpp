@@ -6,7 +6,7 @@
 #include "StatusResponse.h"
 
 StatusRequest::StatusRequest(const uint8_t request_sequence_number, const uint8_t sp_unit, const uint8_t status_code)
-	: Request(request_sequence_number, SP_STATUS, sp_unit), status_code_(status_code) {}
+	: Request(request_sequence_number, SP_STATUS, sp_unit), status_code_(status_code), response_(request_sequence_number, 0) {}
 
 std::vector<uint8_t> StatusRequest::serialize() const
 {
@@ -45,14 +45,10 @@ void StatusRequest::create_command(uint8_t* cmd_data) const
 	cmd_data[4] = status_code_;
 }
 
-std::unique_ptr<Response> StatusRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* StatusRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-    std::unique_ptr<StatusResponse> response = std::make_unique<StatusResponse>(get_request_sequence_number(), status);
-			// Copy the return data if the status is OK
-		if (status == 0) {
-			std::vector<uint8_t> data_vector(data, data + num);
-			response->set_data(data_vector.begin(), data_vector.end());
-		}
-
-    return response;
+	response_.reset(get_request_sequence_number(), status);
+	// Copy the return data if the status is OK
+	response_.set_data_from_ptr(data, status == 0 ? num : 0);
+	return &response_;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include "Request.h"
 #include "Response.h"
+#include "StatusResponse.h"
 
 class StatusRequest : public Request
 {
@@ -13,12 +14,16 @@ public:
 	std::unique_ptr<Response> deserialize(const std::vector<uint8_t>& data) const override;
 
 	uint8_t get_status_code() const { return status_code_; }
+	void set_status_code(const uint8_t status_code) { status_code_ = status_code; }
 
 	void create_command(uint8_t* output_data) const override;
 	void copy_payload(uint8_t* data) const override {}
 	size_t payload_size() const override { return 0; };
-	std::unique_ptr<Response> create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const override;
+	Response* create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) override;
 
 private:
 	uint8_t status_code_;
+
+	// reused for every response to this request
+	StatusResponse response_;
 };
@@ -15,6 +15,11 @@ void StatusResponse::set_data(const std::vector<uint8_t>::const_iterator& begin,
 	std::copy(begin, end, data_.begin()); // NOLINT(performance-unnecessary-value-param)
 }
 
+void StatusResponse::set_data_from_ptr(const uint8_t* ptr, const size_t length)
+{
+	data_.assign(ptr, ptr + length);
+}
+
 std::vector<uint8_t> StatusResponse::serialize() const
 {
 	std::vector<uint8_t> data;
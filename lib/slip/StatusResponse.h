@@ -13,6 +13,10 @@ public:
 	const std::vector<uint8_t>& get_data() const;
 	void add_data(uint8_t d);
 	void set_data(const std::vector<uint8_t>::const_iterator& begin, const std::vector<uint8_t>::const_iterator& end);
+	void set_data_from_ptr(const uint8_t* ptr, size_t length);
+
+	const uint8_t* get_payload() const override { return data_.data(); }
+	size_t get_payload_size() const override { return data_.size(); }
 
 private:
 	std::vector<uint8_t> data_;
@@ -1,11 +1,12 @@
-﻿#include "WriteBlockRequest.h"
+﻿#include <algorithm>
+#include "WriteBlockRequest.h"
 
 #include "WriteBlockResponse.h"
 #include "SmartPortCodes.h"
 
 
 WriteBlockRequest::WriteBlockRequest(const uint8_t request_sequence_number, const uint8_t sp_unit)
-	: Request(request_sequence_number, SP_WRITE_BLOCK, sp_unit), block_number_{}, block_data_{} {}
+	: Request(request_sequence_number, SP_WRITE_BLOCK, sp_unit), block_number_{}, block_data_{}, response_(request_sequence_number, 0) {}
 
 std::vector<uint8_t> WriteBlockRequest::serialize() const
 {
@@ -62,8 +63,8 @@ size_t WriteBlockRequest::payload_size() const {
 	return block_data_.size();
 }
 
-std::unique_ptr<Response> WriteBlockRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* WriteBlockRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-  std::unique_ptr<WriteBlockResponse> response = std::make_unique<WriteBlockResponse>(get_request_sequence_number(), status);
-	return response;
+	response_.reset(get_request_sequence_number(), status);
+	return &response_;
 }
\ No newline at end of file
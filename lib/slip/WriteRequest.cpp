@@ -1,5 +1,6 @@
 ﻿// ReSharper disable CppPassValueParameterByConstReference
 
+#include <algorithm>
 #include "WriteRequest.h"
 
 #include "WriteResponse.h"
@@ -7,7 +8,7 @@
 
 
 WriteRequest::WriteRequest(const uint8_t request_sequence_number, const uint8_t sp_unit)
-	: Request(request_sequence_number, SP_WRITE, sp_unit), byte_count_(), address_()
+	: Request(request_sequence_number, SP_WRITE, sp_unit), byte_count_(), address_(), response_(request_sequence_number, 0)
 {
 }
 
@@ -73,8 +74,8 @@ size_t WriteRequest::payload_size() const {
 	return data_.size();
 }
 
-std::unique_ptr<Response> WriteRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const
+Response* WriteRequest::create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num)
 {
-  std::unique_ptr<WriteResponse> response = std::make_unique<WriteResponse>(get_request_sequence_number(), status);
-	return response;
+	response_.reset(get_request_sequence_number(), status);
+	return &response_;
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 
 #include "Request.h"
 #include "Response.h"
+#include "WriteResponse.h"
 
 class WriteRequest : public Request
 {
@@ -26,11 +27,13 @@ public:
 	void create_command(uint8_t* output_data) const override;
 	void copy_payload(uint8_t* data) const override;
 	size_t payload_size() const override;
-	std::unique_ptr<Response> create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) const override;
+	Response* create_response(uint8_t source, uint8_t status, const uint8_t* data, uint16_t num) override;
 
 private:
 	std::array<uint8_t, 2> byte_count_;
 	std::array<uint8_t, 3> address_;
 	std::vector<uint8_t> data_;
 
+	// reused for every response to this request
+	WriteResponse response_;
 };
@@ -8,6 +8,10 @@ fnTask::fnTask()
     _id = 0;
     _state = TASK_READY;
     _reason = TASK_COMPLETED;
+    _progress = 0;
+    _cancel = false;
+    _threaded = false;
+    _priority = PRIORITY_NORMAL;
     _callback = nullptr;
 }
 
@@ -2,6 +2,7 @@
 #define _FN_TASK_H
 
 #include <stdint.h>
+#include <atomic>
 
 class fnTaskManager;
 
@@ -22,15 +23,29 @@ public:
         TASK_ABORTED
     };
 
+    // worker threads pick higher priority tasks first
+    enum task_priority
+    {
+        PRIORITY_LOW = 0,
+        PRIORITY_NORMAL,
+        PRIORITY_HIGH
+    };
+
     fnTask();
     virtual ~fnTask() = 0;
 
     // state, progress and results
     task_state get_state() {return _state;};
     done_reason get_done_reason() {return _reason;};
-    virtual int get_progress() {return 0;};         // optional
+    virtual int get_progress() {return _progress;}; // optional, safe to call from any thread
     virtual void * get_result() {return nullptr;};  // optional
 
+    // threaded task runs in fnTaskManager worker thread instead of service()
+    bool is_threaded() {return _threaded;};
+    task_priority get_priority() {return _priority;};
+    // abort was requested, long running step() of threaded task should return
+    bool is_cancelled() {return _cancel;};
+
 protected:
     // task state management
     // READY -> RUNNING
@@ -44,11 +59,17 @@ protected:
     // do some work
     virtual int step() = 0;                         // mandatory, must be implemented in sub-class
 
+    void set_progress(int progress) {_progress = progress;};
+
     friend fnTaskManager;
 
     uint8_t _id;                                    // task ID 1..255, 0 is invalid / not yet assigned ID
-    task_state _state;
-    done_reason _reason;
+    std::atomic<task_state> _state;
+    std::atomic<done_reason> _reason;
+    std::atomic<int> _progress;
+    std::atomic<bool> _cancel;
+    bool _threaded;                                 // set in sub-class constructor to opt in
+    task_priority _priority;
     void (*_callback)(fnTask *t, task_state new_state);
 };
 
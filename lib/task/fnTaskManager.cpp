@@ -13,6 +13,7 @@ fnTaskManager::fnTaskManager()
     // Debug_println("fnTaskManager::fnTaskManager");
     _next_tid = 1;
     _task_count = 0;
+    _stop_workers = false;
 }
 
 fnTaskManager::~fnTaskManager()
@@ -23,11 +24,22 @@ fnTaskManager::~fnTaskManager()
 
 void fnTaskManager::shutdown()
 {
+    // let running threaded tasks finish early
+    for (auto it = _task_map.begin(); it != _task_map.end(); ++it)
+        it->second->_cancel = true;
+    stop_workers();
+    _queue.clear();
+    _finished.clear();
+
     // abort tasks, if any
     for (auto it = _task_map.begin(); it != _task_map.end(); ++it)
     {
-        Debug_printf("Aborting task %d\n", it->first);
-        it->second->abort();
+        // threaded task finished by worker is already cleaned up
+        if (it->second->_state != fnTask::TASK_DONE)
+        {
+            Debug_printf("Aborting task %d\n", it->first);
+            it->second->abort();
+        }
         delete it->second;
     }
     _task_map.clear();
@@ -60,6 +72,19 @@ int fnTaskManager::submit_task(fnTask * t)
         _task_map[tid] = t;
         _next_tid = tid+1;
         Debug_printf(" submitted #%d\n", tid);
+
+        if (t->_threaded)
+        {
+            // pass to worker threads, ahead of lower priority tasks
+            if (_workers.empty())
+                start_workers();
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = _queue.begin();
+            while (it != _queue.end() && (*it)->_priority >= t->_priority)
+                ++it;
+            _queue.insert(it, t);
+            _cv.notify_one();
+        }
     }
     return tid;
 }
@@ -97,6 +122,12 @@ int fnTaskManager::pause_task(uint8_t tid)
     fnTask *task = get_task(tid);
     if (task == nullptr)
         return -1;
+    if (task->_threaded)
+    {
+        // worker calls pause() before its next step
+        fnTask::task_state expected = fnTask::TASK_RUNNING;
+        return task->_state.compare_exchange_strong(expected, fnTask::TASK_PAUSED) ? 0 : -1;
+    }
     if (task->_state != fnTask::TASK_RUNNING)
         return -1;
     int result = task->pause();
@@ -111,6 +142,16 @@ int fnTaskManager::resume_task(uint8_t tid)
     fnTask *task = get_task(tid);
     if (task == nullptr)
         return -1;
+    if (task->_threaded)
+    {
+        // worker calls resume() and continues
+        fnTask::task_state expected = fnTask::TASK_PAUSED;
+        if (!task->_state.compare_exchange_strong(expected, fnTask::TASK_RUNNING))
+            return -1;
+        { std::lock_guard<std::mutex> lock(_mutex); }
+        _cv.notify_all();
+        return 0;
+    }
     if (task->_state != fnTask::TASK_PAUSED)
         return -1;
     int result = task->resume();
@@ -125,6 +166,14 @@ int fnTaskManager::abort_task(uint8_t tid)
     fnTask *task = get_task(tid);
     if (task == nullptr)
         return -1;
+    if (task->_threaded)
+    {
+        // worker calls abort(), task is removed by service() when worker is done with it
+        task->_cancel = true;
+        { std::lock_guard<std::mutex> lock(_mutex); }
+        _cv.notify_all();
+        return 0;
+    }
     int result = task->abort();
     task->_state = fnTask::TASK_DONE;
     task->_reason = fnTask::TASK_ABORTED;
@@ -152,11 +201,33 @@ int fnTaskManager::complete_task(uint8_t tid)
     return 0;
 }
 
+void fnTaskManager::reap_threaded()
+{
+    std::list<uint8_t> finished;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        finished.swap(_finished);
+    }
+    for (auto it = finished.begin(); it != finished.end(); ++it)
+    {
+        fnTask *task = get_task(*it);
+        if (task == nullptr)
+            continue;
+        Debug_printf("Threaded task %d %s\n", *it, task->_reason == fnTask::TASK_ABORTED ? "aborted" : "completed");
+        _task_count -= 1;
+        _task_map.erase(*it);
+        delete task;
+    }
+}
+
 bool fnTaskManager::service()
 {
     if (_task_count == 0)
         return true; // idle
 
+    // remove tasks finished by worker threads
+    reap_threaded();
+
     bool idle = true; // was service() idle?
     int result;
     fnTask *task;
@@ -167,6 +238,8 @@ bool fnTaskManager::service()
     for (auto it = _task_map.begin(); it != _task_map.end(); ++it)
     {
         task = it->second;
+        if (task->_threaded)
+            continue; // taken care of by worker thread
         switch (task->_state)
         {
         case fnTask::TASK_READY:
@@ -208,3 +281,91 @@ bool fnTaskManager::service()
 
     return idle;
 }
+
+void fnTaskManager::start_workers()
+{
+    Debug_printf("Starting %d task worker threads\n", FN_TASK_WORKERS);
+    _stop_workers = false;
+    for (int i = 0; i < FN_TASK_WORKERS; i++)
+        _workers.emplace_back(&fnTaskManager::worker_loop, this);
+}
+
+void fnTaskManager::stop_workers()
+{
+    if (_workers.empty())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop_workers = true;
+    }
+    _cv.notify_all();
+    for (auto &w : _workers)
+        w.join();
+    _workers.clear();
+}
+
+void fnTaskManager::worker_loop()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true)
+    {
+        _cv.wait(lock, [this] { return _stop_workers || !_queue.empty(); });
+        if (_stop_workers)
+            break;
+        fnTask *task = _queue.front();
+        _queue.pop_front();
+
+        lock.unlock();
+        run_threaded(task);
+        lock.lock();
+        // hand over to service() for removal
+        _finished.push_back(task->_id);
+    }
+}
+
+void fnTaskManager::run_threaded(fnTask *task)
+{
+    int result = 0;
+
+    if (!task->_cancel)
+    {
+        result = task->start();
+        if (result >= 0)
+        {
+            fnTask::task_state expected = fnTask::TASK_READY;
+            task->_state.compare_exchange_strong(expected, fnTask::TASK_RUNNING);
+            result = 0;
+        }
+    }
+
+    // step until task completes (> 0), fails (< 0) or gets cancelled
+    while (result == 0 && !task->_cancel)
+    {
+        if (task->_state == fnTask::TASK_PAUSED)
+        {
+            task->pause();
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _cv.wait(lock, [this, task] {
+                    return task->_state != fnTask::TASK_PAUSED || task->_cancel || _stop_workers;
+                });
+            }
+            if (task->_state == fnTask::TASK_PAUSED)
+                break; // cancelled while paused
+            task->resume();
+            continue;
+        }
+        result = task->step();
+    }
+
+    if (result > 0)
+    {
+        task->_reason = fnTask::TASK_COMPLETED;
+    }
+    else
+    {
+        task->abort();
+        task->_reason = fnTask::TASK_ABORTED;
+    }
+    task->_state = fnTask::TASK_DONE;
+}
@@ -3,9 +3,15 @@
 
 #include <stdint.h>
 #include <map>
+#include <list>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "fnTask.h"
 
+#define FN_TASK_WORKERS 2 // worker threads for threaded tasks, started on first use
 
 class fnTaskManager
 {
@@ -19,15 +25,29 @@ public:
     int resume_task(uint8_t tid);
     int abort_task(uint8_t tid);
     bool service();
+    void shutdown();
 
 private:
     int complete_task(uint8_t tid);
     uint8_t get_free_tid();
-    void shutdown();
+    void reap_threaded();
 
     std::map<uint8_t, fnTask *> _task_map;
     uint8_t _next_tid;
     uint8_t _task_count;
+
+    // worker pool for threaded tasks
+    void start_workers();
+    void stop_workers();
+    void worker_loop();
+    void run_threaded(fnTask *task);
+
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;              // guards members below
+    std::condition_variable _cv;
+    std::list<fnTask *> _queue;     // threaded tasks waiting for worker, by priority
+    std::list<uint8_t> _finished;   // threaded tasks done, to be deleted by service()
+    bool _stop_workers;
 };
 
 // global task manager
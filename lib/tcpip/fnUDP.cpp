@@ -5,6 +5,9 @@
 #include <cstring>
 #include <fcntl.h>
 #include <errno.h>
+#if !defined(_WIN32)
+#include <sys/select.h>
+#endif
 
 #include "../../include/debug.h"
 
@@ -262,6 +265,30 @@ int fnUDP::parsePacket()
     return len;
 }
 
+bool fnUDP::waitForPacket(int timeout_ms)
+{
+    if (rx_buffer)
+        return true;
+    if (udp_server == -1)
+        return false;
+
+    fd_set fdset;
+    FD_ZERO(&fdset);
+    FD_SET(udp_server, &fdset);
+
+    struct timeval tv;
+    tv.tv_sec = timeout_ms / 1000;
+    tv.tv_usec = (timeout_ms - tv.tv_sec*1000) * 1000;
+
+    int res = select(udp_server + 1, &fdset, nullptr, nullptr, &tv);
+    if (res < 0)
+    {
+        Debug_printf("could not wait for data: %d\n", compat_getsockerr());
+        return false;
+    }
+    return res > 0;
+}
+
 int fnUDP::read()
 {
     if (!rx_buffer)
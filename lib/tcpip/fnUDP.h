@@ -43,6 +43,8 @@ public:
     size_t write(const uint8_t *buffer, size_t size);
 
     int parsePacket();
+    // Waits at most timeout_ms for a packet, returns true if one can be parsed
+    bool waitForPacket(int timeout_ms);
 
     int read();
     int read(unsigned char* buffer, size_t len);
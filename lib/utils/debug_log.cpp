@@ -0,0 +1,364 @@
+#include "debug_log.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <time.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utils.h"
+#include "spsc_ring.h"
+
+std::atomic<uint8_t> util_debug_levels[DEBUG_SYS_COUNT] = {
+    DEBUG_LEVEL_VERBOSE, DEBUG_LEVEL_VERBOSE, DEBUG_LEVEL_VERBOSE, DEBUG_LEVEL_VERBOSE,
+    DEBUG_LEVEL_VERBOSE, DEBUG_LEVEL_VERBOSE, DEBUG_LEVEL_VERBOSE, DEBUG_LEVEL_VERBOSE,
+    DEBUG_LEVEL_VERBOSE, DEBUG_LEVEL_VERBOSE, DEBUG_LEVEL_VERBOSE
+};
+
+static const char *debug_subsys_names[DEBUG_SYS_COUNT] = {
+    "other", "sio", "iwm", "tnfs", "http", "network", "media", "fs", "modem", "printer", "fuji"
+};
+
+// record in thread ring: header followed by message text
+struct debug_record_hdr
+{
+    int64_t time_us;    // wall clock, microseconds since epoch
+    uint16_t len;       // message length
+    uint8_t newline;    // start new line before time prefix
+    uint8_t timestamp;  // print time prefix
+};
+
+struct debug_thread_ring
+{
+    SpscRing<char, DEBUG_LOG_RING_SIZE> ring;
+    bool print_ts = true;               // producer only
+    std::atomic<bool> exited{false};    // thread is gone, ring can be freed when empty
+};
+
+static std::atomic<bool> s_async{true};
+static std::atomic<bool> s_running{false};  // flusher thread is running
+static std::once_flag s_start_once;
+static bool s_print_ts = true;              // used in synchronous mode
+
+static void debug_log_drain();
+
+struct debug_log_state
+{
+    std::mutex rings_mutex;
+    std::vector<debug_thread_ring *> rings;     // rings of all threads which logged something
+
+    std::mutex flush_mutex;                     // single consumer of all rings
+    std::condition_variable flush_cv;
+    bool stop = false;
+    std::thread flusher;
+
+    // stop flusher thread at exit, messages logged later are written directly
+    ~debug_log_state()
+    {
+        if (!flusher.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock(flush_mutex);
+            stop = true;
+        }
+        // writers waiting for room in full ring write directly from now on
+        s_running = false;
+        flush_cv.notify_one();
+        flusher.join();
+        debug_log_drain();
+    }
+};
+
+// created on first use, Debug_print* may be called from constructors of globals
+static debug_log_state &debug_log()
+{
+    static debug_log_state state;
+    return state;
+}
+
+// marks thread ring as exited when thread ends
+struct debug_thread_ring_holder
+{
+    debug_thread_ring *ring = nullptr;
+    ~debug_thread_ring_holder();
+};
+
+static thread_local debug_thread_ring_holder tl_ring;
+static thread_local bool tl_ring_gone = false;
+
+debug_thread_ring_holder::~debug_thread_ring_holder()
+{
+    tl_ring_gone = true;
+    if (ring != nullptr)
+        ring->exited = true;
+}
+
+static void debug_log_flusher()
+{
+    debug_log_state &state = debug_log();
+    std::unique_lock<std::mutex> lock(state.flush_mutex);
+    while (!state.stop)
+    {
+        state.flush_cv.wait_for(lock, std::chrono::milliseconds(DEBUG_LOG_FLUSH_MS));
+        lock.unlock();
+        debug_log_drain();
+        lock.lock();
+    }
+}
+
+static void debug_log_start()
+{
+    debug_log_state &state = debug_log();
+    state.flusher = std::thread(debug_log_flusher);
+    s_running = true;
+}
+
+static int64_t debug_log_time_us()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// "HH:MM:SS.uuuuuu > "
+static void debug_log_format_time(int64_t time_us, char *buffer, size_t size)
+{
+    static time_t last_sec = -1;
+    static char last_hms[16];
+
+    time_t sec = (time_t)(time_us / 1000000);
+    if (sec != last_sec)
+    {
+        tm tm;
+#if defined(_WIN32)
+        localtime_s(&tm, &sec);
+#else
+        localtime_r(&sec, &tm);
+#endif
+        strftime(last_hms, sizeof(last_hms), "%H:%M:%S", &tm);
+        last_sec = sec;
+    }
+    snprintf(buffer, size, "%s.%06d > ", last_hms, (int)(time_us % 1000000));
+}
+
+static void debug_log_output(std::string &out, const debug_record_hdr &hdr, const char *text)
+{
+    char ts[32];
+    if (hdr.newline)
+        out += '\n';
+    if (hdr.timestamp)
+    {
+        debug_log_format_time(hdr.time_us, ts, sizeof(ts));
+        out += ts;
+    }
+    out.append(text, hdr.len);
+}
+
+// write out records from all rings, ordered by time
+static void debug_log_drain()
+{
+    struct record
+    {
+        debug_record_hdr hdr;
+        size_t pos;
+    };
+    std::vector<record> records;
+    std::string texts;
+    std::string out;
+
+    debug_log_state &state = debug_log();
+    std::lock_guard<std::mutex> flush_lock(state.flush_mutex);
+    {
+        std::lock_guard<std::mutex> lock(state.rings_mutex);
+        for (auto it = state.rings.begin(); it != state.rings.end();)
+        {
+            debug_thread_ring *r = *it;
+            // producer always puts complete record
+            bool exited = r->exited;
+            debug_record_hdr hdr;
+            while (r->ring.get((char *)&hdr, sizeof(hdr)) == sizeof(hdr))
+            {
+                size_t pos = texts.size();
+                texts.resize(pos + hdr.len);
+                r->ring.get(&texts[pos], hdr.len);
+                records.push_back({hdr, pos});
+            }
+            if (exited)
+            {
+                delete r;
+                it = state.rings.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+    if (records.empty())
+        return;
+
+    // messages from same thread keep their order
+    std::stable_sort(records.begin(), records.end(),
+        [](const record &a, const record &b) { return a.hdr.time_us < b.hdr.time_us; });
+
+    for (auto &rec : records)
+        debug_log_output(out, rec.hdr, texts.data() + rec.pos);
+    fwrite(out.data(), 1, out.size(), stdout);
+    fflush(stdout);
+}
+
+static debug_thread_ring *debug_log_thread_ring()
+{
+    if (tl_ring.ring == nullptr && !tl_ring_gone)
+    {
+        tl_ring.ring = new debug_thread_ring;
+        debug_log_state &state = debug_log();
+        std::lock_guard<std::mutex> lock(state.rings_mutex);
+        state.rings.push_back(tl_ring.ring);
+    }
+    return tl_ring.ring;
+}
+
+// helper function for Debug_print* macros on fujinet-pc
+void util_debug_printf(const char *fmt, ...)
+{
+    char buf[sizeof(debug_record_hdr) + DEBUG_LOG_LINE_MAX];
+    char *text = buf + sizeof(debug_record_hdr);
+    va_list argp;
+    int len;
+
+    va_start(argp, fmt);
+    if (fmt != nullptr)
+    {
+        len = vsnprintf(text, DEBUG_LOG_LINE_MAX, fmt, argp);
+    }
+    else
+    {
+        const char *s = va_arg(argp, const char*);
+        len = snprintf(text, DEBUG_LOG_LINE_MAX, "%s", s);
+    }
+    va_end(argp);
+    if (len <= 0)
+        return;
+    if (len >= DEBUG_LOG_LINE_MAX)
+        len = DEBUG_LOG_LINE_MAX - 1;
+    bool ends_line = text[len - 1] == '\n';
+
+    if (s_async)
+        std::call_once(s_start_once, debug_log_start);
+
+    debug_thread_ring *r = nullptr;
+    if (s_async && s_running)
+        r = debug_log_thread_ring();
+
+    // print_ts: previous message finished the line
+    bool &print_ts = r != nullptr ? r->print_ts : s_print_ts;
+    debug_record_hdr hdr;
+    hdr.time_us = debug_log_time_us();
+    hdr.len = (uint16_t)len;
+    hdr.newline = !print_ts && ends_line;
+    hdr.timestamp = print_ts || ends_line;
+    print_ts = ends_line;
+
+    if (r == nullptr)
+    {
+        // synchronous mode, or thread/program is exiting
+        std::string out;
+        debug_log_output(out, hdr, text);
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+        return;
+    }
+
+    memcpy(buf, &hdr, sizeof(hdr));
+    size_t size = sizeof(hdr) + len;
+    // ring is full, let flusher make room
+    while (r->ring.room() < size)
+    {
+        if (!s_running)
+        {
+            // flusher is gone (program is exiting), write what is queued and this one directly
+            debug_log_drain();
+            std::string out;
+            debug_log_output(out, hdr, text);
+            fwrite(out.data(), 1, out.size(), stdout);
+            fflush(stdout);
+            return;
+        }
+        debug_log().flush_cv.notify_one();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    r->ring.put(buf, size);
+    if (r->ring.available() > DEBUG_LOG_RING_SIZE / 2)
+        debug_log().flush_cv.notify_one();
+}
+
+void util_debug_set_async(bool async)
+{
+    if (!async)
+        util_debug_flush();
+    s_async = async;
+}
+
+void util_debug_flush()
+{
+    if (s_running)
+        debug_log_drain();
+}
+
+bool util_debug_set_levels(const std::string &levels)
+{
+    bool ok = true;
+    size_t pos = 0;
+    while (pos < levels.size())
+    {
+        size_t end = levels.find(',', pos);
+        if (end == std::string::npos)
+            end = levels.size();
+        std::string item = levels.substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t eq = item.find('=');
+        if (eq == std::string::npos)
+        {
+            ok = item.find_first_not_of(" \t") == std::string::npos; // ignore empty item
+            continue;
+        }
+        std::string name = item.substr(0, eq);
+        name.erase(std::remove_if(name.begin(), name.end(), ::isspace), name.end());
+        int level = atoi(item.c_str() + eq + 1);
+        if (level < DEBUG_LEVEL_OFF)
+            level = DEBUG_LEVEL_OFF;
+        if (level > DEBUG_LEVEL_TRACE)
+            level = DEBUG_LEVEL_TRACE;
+
+        bool found = false;
+        for (int i = 0; i < DEBUG_SYS_COUNT; i++)
+        {
+            if (name == "all" || name == debug_subsys_names[i])
+            {
+                util_debug_levels[i] = (uint8_t)level;
+                found = true;
+            }
+        }
+        if (!found)
+            ok = false;
+    }
+    return ok;
+}
+
+std::string util_debug_get_levels()
+{
+    std::string result;
+    for (int i = 0; i < DEBUG_SYS_COUNT; i++)
+    {
+        if (i > 0)
+            result += ',';
+        result += debug_subsys_names[i];
+        result += '=';
+        result += std::to_string(util_debug_levels[i].load());
+    }
+    return result;
+}
@@ -0,0 +1,97 @@
+#ifndef DEBUG_LOG_H
+#define DEBUG_LOG_H
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <type_traits>
+
+/*
+ * Asynchronous debug log behind Debug_print* macros
+ * The calling thread formats the message into its own lock-free ring together
+ * with a raw timestamp. Background thread formats the time prefix and writes
+ * the messages to stdout in batches.
+ * Messages are filtered by per-subsystem level, subsystem is derived from
+ * the source file path at compile time.
+ */
+
+enum debug_subsys_t
+{
+    DEBUG_SYS_OTHER = 0,
+    DEBUG_SYS_SIO,
+    DEBUG_SYS_IWM,
+    DEBUG_SYS_TNFS,
+    DEBUG_SYS_HTTP,
+    DEBUG_SYS_NETWORK,
+    DEBUG_SYS_MEDIA,
+    DEBUG_SYS_FS,
+    DEBUG_SYS_MODEM,
+    DEBUG_SYS_PRINTER,
+    DEBUG_SYS_FUJI,
+    DEBUG_SYS_COUNT
+};
+
+#define DEBUG_LEVEL_OFF     0
+#define DEBUG_LEVEL_INFO    1 // Debug_print, Debug_printf, Debug_println
+#define DEBUG_LEVEL_VERBOSE 2 // Debug_printv too
+#define DEBUG_LEVEL_TRACE   3 // packet dumps, above default level, enabled explicitly
+
+#define DEBUG_LOG_RING_SIZE 65536 // per thread, must be power of two
+#define DEBUG_LOG_LINE_MAX  1024  // longer messages are truncated
+#define DEBUG_LOG_FLUSH_MS  10    // max delay before messages are written
+
+// does path contain part, '\' matches '/'
+constexpr bool util_debug_path_has(const char *path, const char *part)
+{
+    for (; *path; path++)
+    {
+        int i = 0;
+        while (part[i] && (path[i] == part[i] || (path[i] == '\\' && part[i] == '/')))
+            i++;
+        if (part[i] == '\0')
+            return true;
+    }
+    return false;
+}
+
+// subsystem of source file, first match wins
+// device files (lib/device/<bus>/modem.cpp etc.) go to their own subsystem, the rest of the bus directory to the bus
+constexpr int util_debug_subsys(const char *path)
+{
+    return
+        util_debug_path_has(path, "TNFS") || util_debug_path_has(path, "tnfs") ? DEBUG_SYS_TNFS :
+        util_debug_path_has(path, "/http/") || util_debug_path_has(path, "/webdav/") ? DEBUG_SYS_HTTP :
+        util_debug_path_has(path, "/modem") ? DEBUG_SYS_MODEM :
+        util_debug_path_has(path, "/printer") ? DEBUG_SYS_PRINTER :
+        util_debug_path_has(path, "/fuji/") || util_debug_path_has(path, "/fuji.") ? DEBUG_SYS_FUJI :
+        util_debug_path_has(path, "/network-protocol/") || util_debug_path_has(path, "/network.") ||
+            util_debug_path_has(path, "/tcpip/") || util_debug_path_has(path, "/ftp/") ||
+            util_debug_path_has(path, "/telnet/") ? DEBUG_SYS_NETWORK :
+        util_debug_path_has(path, "/iwm/") || util_debug_path_has(path, "/slip/") ? DEBUG_SYS_IWM :
+        util_debug_path_has(path, "/sio/") ? DEBUG_SYS_SIO :
+        util_debug_path_has(path, "/media/") ? DEBUG_SYS_MEDIA :
+        util_debug_path_has(path, "/FileSystem/") ? DEBUG_SYS_FS :
+        DEBUG_SYS_OTHER;
+}
+
+// subsystem of current source file, evaluated by compiler
+#define DEBUG_SUBSYS (std::integral_constant<int, util_debug_subsys(__FILE__)>::value)
+
+extern std::atomic<uint8_t> util_debug_levels[DEBUG_SYS_COUNT];
+
+inline bool util_debug_enabled(int subsys, int level)
+{
+    return util_debug_levels[subsys].load(std::memory_order_relaxed) >= level;
+}
+
+// set levels from "name=level,..." list, "all" sets every subsystem, e.g. "all=1,sio=2,http=0"
+bool util_debug_set_levels(const std::string &levels);
+// current levels as "name=level,..." list
+std::string util_debug_get_levels();
+
+// async (default) or synchronous writing of messages
+void util_debug_set_async(bool async);
+// write out everything logged so far
+void util_debug_flush();
+
+#endif // DEBUG_LOG_H
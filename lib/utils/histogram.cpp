@@ -0,0 +1,79 @@
+#include "histogram.h"
+
+#include <string.h>
+
+void Histogram::reset()
+{
+    memset(_buckets, 0, sizeof(_buckets));
+    _count = 0;
+    _sum = 0;
+    _min = UINT64_MAX;
+    _max = 0;
+}
+
+int Histogram::bucket_index(uint64_t value)
+{
+    if (value < HISTOGRAM_SUB_BUCKETS)
+        return (int)value; // exact
+
+    if (value >> HISTOGRAM_VALUE_BITS)
+        return HISTOGRAM_BUCKETS - 1; // saturate
+
+    // position of highest bit set
+    int msb = 63 - __builtin_clzll(value);
+    int shift = msb - HISTOGRAM_SUB_BITS;
+    int sub = (int)(value >> shift) & (HISTOGRAM_SUB_BUCKETS - 1);
+    return (shift + 1) * HISTOGRAM_SUB_BUCKETS + sub;
+}
+
+// middle of the bucket value range
+uint64_t Histogram::bucket_value(int index)
+{
+    if (index < HISTOGRAM_SUB_BUCKETS)
+        return index;
+
+    int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    uint64_t sub = index % HISTOGRAM_SUB_BUCKETS;
+    uint64_t lower = (HISTOGRAM_SUB_BUCKETS + sub) << shift;
+    return lower + ((1ULL << shift) >> 1);
+}
+
+void Histogram::record(uint64_t value)
+{
+    _buckets[bucket_index(value)]++;
+    _count++;
+    _sum += value;
+    if (value < _min)
+        _min = value;
+    if (value > _max)
+        _max = value;
+}
+
+uint64_t Histogram::percentile(double p) const
+{
+    if (_count == 0)
+        return 0;
+
+    uint64_t target = (uint64_t)(p / 100.0 * _count + 0.5);
+    if (target < 1)
+        target = 1;
+    if (target >= _count)
+        return _max;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        seen += _buckets[i];
+        if (seen >= target)
+        {
+            uint64_t value = bucket_value(i);
+            // bucket middle can be outside of recorded range
+            if (value < _min)
+                return _min;
+            if (value > _max)
+                return _max;
+            return value;
+        }
+    }
+    return _max;
+}
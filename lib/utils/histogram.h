@@ -0,0 +1,47 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdint.h>
+
+/*
+ * Fixed size log-linear histogram (HDR style)
+ * Values are counted in buckets, each power of two range is split into
+ * HISTOGRAM_SUB_BUCKETS linear sub-buckets, i.e. relative error of reported
+ * percentiles is below 1/HISTOGRAM_SUB_BUCKETS.
+ * No memory is allocated, recording is just a few arithmetic operations.
+ */
+
+#define HISTOGRAM_SUB_BITS      3
+#define HISTOGRAM_SUB_BUCKETS   (1 << HISTOGRAM_SUB_BITS)
+// values up to 2^32-1 (in microseconds it's over an hour)
+#define HISTOGRAM_VALUE_BITS    32
+#define HISTOGRAM_BUCKETS       ((HISTOGRAM_VALUE_BITS - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_BUCKETS)
+
+class Histogram
+{
+private:
+    uint32_t _buckets[HISTOGRAM_BUCKETS];
+    uint64_t _count;
+    uint64_t _sum;
+    uint64_t _min;
+    uint64_t _max;
+
+    static int bucket_index(uint64_t value);
+    static uint64_t bucket_value(int index);
+
+public:
+    Histogram() { reset(); }
+
+    void reset();
+    void record(uint64_t value);
+
+    uint64_t count() const { return _count; }
+    uint64_t min() const { return _count ? _min : 0; }
+    uint64_t max() const { return _max; }
+    uint64_t mean() const { return _count ? _sum / _count : 0; }
+
+    // value below which given percentage (0.0 .. 100.0) of recorded values falls
+    uint64_t percentile(double p) const;
+};
+
+#endif // HISTOGRAM_H
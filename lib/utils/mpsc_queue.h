@@ -0,0 +1,158 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+
+/*
+ * Lock-free multiple producer, single consumer queue (unbounded, linked list)
+ * Any thread may push(), only one thread may pop().
+ * push() is wait-free, pop() may return false for a moment while a push
+ * is half-way done; the element is returned by a later pop().
+ */
+
+template <typename T>
+class MpscQueue
+{
+private:
+    struct node
+    {
+        std::atomic<node *> next{nullptr};
+        T value;
+    };
+
+    // producers append at head, consumer removes from tail
+    alignas(64) std::atomic<node *> _head;
+    alignas(64) node *_tail;
+
+public:
+    MpscQueue()
+    {
+        node *stub = new node;
+        _head.store(stub, std::memory_order_relaxed);
+        _tail = stub;
+    }
+
+    ~MpscQueue()
+    {
+        T value;
+        while (pop(value))
+            ;
+        delete _tail;
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    // producer: any thread
+    void push(T value)
+    {
+        node *n = new node;
+        n->value = std::move(value);
+        node *prev = _head.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    // consumer: returns false if queue is empty
+    bool pop(T &value)
+    {
+        node *tail = _tail;
+        node *next = tail->next.load(std::memory_order_acquire);
+        if (next == nullptr)
+            return false;
+        value = std::move(next->value);
+        _tail = next; // next becomes new stub
+        delete tail;
+        return true;
+    }
+
+    // consumer: true if there is nothing to pop
+    bool empty() const
+    {
+        return _tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+};
+
+/*
+ * Lock-free multiple producer, single consumer bounded queue (Vyukov's array
+ * based queue), no memory is allocated after construction.
+ * Elements are exchanged with the slots (std::swap), i.e. buffers owned by
+ * elements (e.g. std::vector) keep circulating with their capacity.
+ * N must be a power of two.
+ */
+
+template <typename T, size_t N>
+class MpscRing
+{
+    static_assert((N & (N - 1)) == 0, "MpscRing size must be power of two");
+
+private:
+    struct cell
+    {
+        std::atomic<size_t> seq;
+        T value;
+    };
+
+    cell _cells[N];
+    alignas(64) std::atomic<size_t> _enqueue_pos{0};
+    alignas(64) size_t _dequeue_pos = 0;
+
+public:
+    MpscRing()
+    {
+        for (size_t i = 0; i < N; i++)
+            _cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    // producer: any thread, returns false if queue is full
+    // on success value holds what was left in the slot by a previous pop()
+    bool push(T &value)
+    {
+        cell *c;
+        size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            c = &_cells[pos & (N - 1)];
+            size_t seq = c->seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0)
+            {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (dif < 0)
+                return false; // full
+            else
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+        }
+        std::swap(c->value, value);
+        c->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer: returns false if queue is empty
+    // value previously held by caller is left in the slot for reuse by push()
+    bool pop(T &value)
+    {
+        cell *c = &_cells[_dequeue_pos & (N - 1)];
+        if (c->seq.load(std::memory_order_acquire) != _dequeue_pos + 1)
+            return false;
+        std::swap(c->value, value);
+        c->seq.store(_dequeue_pos + N, std::memory_order_release);
+        _dequeue_pos++;
+        return true;
+    }
+
+    // consumer: true if there is nothing to pop
+    bool empty() const
+    {
+        return _cells[_dequeue_pos & (N - 1)].seq.load(std::memory_order_acquire) != _dequeue_pos + 1;
+    }
+};
+
+#endif // MPSC_QUEUE_H
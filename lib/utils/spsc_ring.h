@@ -0,0 +1,85 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+
+/*
+ * Lock-free single producer, single consumer ring buffer
+ * One thread may only put(), other thread may only get()/discard().
+ * Capacity N must be power of two, the ring holds up to N elements.
+ */
+
+template <typename T, size_t N>
+class SpscRing
+{
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRing capacity must be power of two");
+
+private:
+    T _buf[N];
+    // free running indexes, head is written by producer, tail by consumer
+    alignas(64) std::atomic<size_t> _head{0};
+    alignas(64) std::atomic<size_t> _tail{0};
+
+public:
+    size_t capacity() const { return N; }
+    size_t available() const { return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire); }
+    size_t room() const { return N - available(); }
+    bool empty() const { return available() == 0; }
+
+    // producer: put single element, returns false if ring is full
+    bool put(const T &item)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) >= N)
+            return false;
+        _buf[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // producer: put up to count elements, returns number of elements stored
+    size_t put(const T *items, size_t count)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t room = N - (head - _tail.load(std::memory_order_acquire));
+        if (count > room)
+            count = room;
+        for (size_t i = 0; i < count; i++)
+            _buf[(head + i) & (N - 1)] = items[i];
+        _head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // consumer: get single element, returns false if ring is empty
+    bool get(T &item)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (_head.load(std::memory_order_acquire) == tail)
+            return false;
+        item = _buf[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer: get up to count elements, returns number of elements retrieved
+    size_t get(T *items, size_t count)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        size_t avail = _head.load(std::memory_order_acquire) - tail;
+        if (count > avail)
+            count = avail;
+        for (size_t i = 0; i < count; i++)
+            items[i] = _buf[(tail + i) & (N - 1)];
+        _tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // consumer: drop everything received so far
+    void discard()
+    {
+        _tail.store(_head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+};
+
+#endif // SPSC_RING_H
@@ -8,7 +8,6 @@
 #include <cmath>
 #include <cstdarg>
 #include "compat_string.h"
-#include "compat_gettimeofday.h"
 
 #include "../../include/debug.h"
 
@@ -143,6 +142,17 @@ unsigned char util_checksum(const char *chunk, int length)
     return (unsigned char)chkSum;
 }
 
+uint64_t util_hash64(const void *data, size_t len, uint64_t hash)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= p[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
 std::string util_crunch(std::string filename)
 {
     std::string basename_long;
@@ -911,61 +921,3 @@ std::string prependSlash(const std::string& str) {
     }
     return str;
 }
-
-// helper function for Debug_print* macros on fujinet-pc
-void util_debug_printf(const char *fmt, ...)
-{
-    static bool print_ts = true;
-    va_list argp;
-
-    if (!print_ts)
-    {
-        if (fmt != nullptr)
-        {
-            print_ts = fmt[strlen(fmt)-1] == '\n';
-        }
-        else
-        {
-            va_start(argp, fmt);
-            const char *s = va_arg(argp, const char*);
-            print_ts = s[strlen(s)-1] == '\n';
-            va_end(argp);
-        }
-        if (print_ts)
-            printf("\n");
-    }
-
-    if (print_ts) 
-    {
-        // printf("DEBUG > ");
-        timeval tv;
-        tm tm;
-        char buffer[32];
-
-        compat_gettimeofday(&tv, NULL);
-#if defined(_WIN32)
-        time_t t = (time_t)tv.tv_sec;
-        localtime_s(&tm, &t);
-#else
-        localtime_r(&tv.tv_sec, &tm);
-#endif
-        size_t endpos = strftime(buffer, sizeof(buffer), "%H:%M:%S", &tm);
-        snprintf(buffer + endpos, sizeof(buffer) - endpos, ".%06d", (int)(tv.tv_usec));
-        printf("%s > ", buffer);
-    }
-
-    va_start(argp, fmt);
-    if (fmt != nullptr)
-    {
-        print_ts = fmt[strlen(fmt)-1] == '\n';
-        vprintf(fmt, argp);
-    }
-    else
-    {
-        const char *s = va_arg(argp, const char*);
-        print_ts = s[strlen(s)-1] == '\n';
-        printf("%s", s);
-    }
-    va_end(argp);
-    fflush(stdout);
-}
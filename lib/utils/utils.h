@@ -51,6 +51,8 @@ long util_parseInt(FILE *f, char skipChar);
 long util_parseInt(FILE *f);
 
 unsigned char util_checksum(const char *chunk, int length);
+// FNV-1a, pass previous result as hash to continue
+uint64_t util_hash64(const void *data, size_t len, uint64_t hash = 0xcbf29ce484222325ULL);
 std::string util_crunch(std::string filename);
 std::string util_entry(std::string crunched, size_t fileSize, bool is_dir, bool is_locked);
 std::string util_long_entry(std::string filename, size_t fileSize, bool is_dir);
@@ -105,7 +107,7 @@ bool isApproximatelyInteger(double value, double tolerance = 1e-6);
 // ensure string starts with a "/"
 std::string prependSlash(const std::string& str);
 
-// helper function for Debug_print* macros on fujinet-pc
+// helper function for Debug_print* macros on fujinet-pc, implemented in debug_log.cpp
 void util_debug_printf(const char *fmt, ...);
 
 #endif // _FN_UTILS_H
@@ -0,0 +1,2048 @@
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <atomic>
+#include <initializer_list>
+
+#include "fnSystem.h"
+#include "histogram.h"
+#include "debug_log.h"
+
+#include "SLIP.h"
+#include "RequestPool.h"
+#include "SmartPortCodes.h"
+#include "compat_inet.h"
+#include "tnfslib.h"
+#include "fnFsTNFS.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "fnUART.h"
+#endif
+
+#ifdef BUILD_APPLE
+#ifndef _WIN32
+#include <netinet/tcp.h>
+#endif
+#include "fnFileLocal.h"
+#include "iwm/TCPConnection.h"
+#include "iwm/UDPConnection.h"
+#include "apple/mediaTypePO.h"
+#include "apple/mediaTypeDO.h"
+#include "apple/mediaTypeWOZ.h"
+#if defined(__linux__)
+#include <queue>
+#include <mutex>
+#include "fnEventLoop.h"
+#include "iwm/iwm_slip.h"
+#endif
+#endif
+
+#ifdef BUILD_ATARI
+#include <filesystem>
+#include "compat_string.h"
+#include "fnFileLocal.h"
+#include "fnFsSD.h"
+#include "fnFileWriteBehind.h"
+#include "fnFileFetch.h"
+#include "fnConfig.h"
+#include "atari/diskTypeAtr.h"
+#include "fuji.h"
+#include "fnWiFi.h"
+#include "sio/siocom/netsio.h"
+#include "sio/siocom/netsio_proto.h"
+#include "fsFlash.h"
+#include "httpService.h"
+#endif
+
+
+// for latencies below fnSystem.micros() resolution
+static uint64_t nanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static double per_second(uint64_t count, uint64_t us)
+{
+    return count * 1e6 / (us ? us : 1);
+}
+
+// Heap allocations made by a thread while it counts them, global operator new is replaced for that
+static thread_local bool count_allocations = false;
+static thread_local long allocations = 0;
+
+void *operator new(size_t size)
+{
+    if (count_allocations)
+        allocations++;
+    void *p = malloc(size ? size : 1);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t size) noexcept
+{
+    free(p);
+}
+
+// Achieved delay_microseconds() against requested one, in both delay modes
+static void benchmark_delay()
+{
+    const uint32_t delays[] = {100, 250, 850, 1000, 5000};
+    const int rounds = 500;
+    const SystemManager::delay_modes modes[] = {SystemManager::DELAY_MODE_SLEEP, SystemManager::DELAY_MODE_PRECISE};
+
+    SystemManager::delay_modes mode_was = fnSystem.get_delay_mode();
+    for (auto mode : modes)
+    {
+        fnSystem.set_delay_mode(mode);
+        fprintf(stderr, "%s delay:\n", mode == SystemManager::DELAY_MODE_PRECISE ? "Precise" : "Sleep");
+        fprintf(stderr, "  requested      min      p50      p95      p99      max  (us)\n");
+        for (uint32_t us : delays)
+        {
+            Histogram h;
+            for (int i = 0; i < rounds; i++)
+            {
+                uint64_t t = fnSystem.micros();
+                fnSystem.delay_microseconds(us);
+                h.record(fnSystem.micros() - t);
+            }
+            fprintf(stderr, "  %9u %8llu %8llu %8llu %8llu %8llu\n", us,
+                (unsigned long long)h.min(), (unsigned long long)h.percentile(50.0),
+                (unsigned long long)h.percentile(95.0), (unsigned long long)h.percentile(99.0),
+                (unsigned long long)h.max());
+        }
+    }
+    fnSystem.set_delay_mode(mode_was);
+}
+
+// Encode and decode SmartPort sized packets, decoder fed in TCP sized pieces
+static void benchmark_slip()
+{
+    const size_t sizes[] = {8, 512, 4096};
+    const size_t chunk = 1460;
+    const int rounds = 20000;
+
+    std::vector<uint8_t> encoded;
+    SLIPDecoder decoder;
+
+    fprintf(stderr, "SLIP codec, %d packets per size:\n", rounds);
+    fprintf(stderr, "   size  encode pkt/s  encode MB/s  allocs/pkt  decode pkt/s  decode MB/s  allocs/pkt\n");
+    for (size_t size : sizes)
+    {
+        // every 16th byte needs escaping
+        std::vector<uint8_t> packet(size);
+        for (size_t i = 0; i < size; i++)
+            packet[i] = i % 16 == 0 ? SLIP_END : (uint8_t)i;
+
+        size_t len = 0;
+        size_t encoded_total = 0;
+        allocations = 0;
+        count_allocations = true;
+        uint64_t t = fnSystem.micros();
+        for (int r = 0; r < rounds; r++)
+        {
+            len = SLIP::encode(packet.data(), packet.size(), encoded);
+            encoded_total += len;
+        }
+        uint64_t t_encode = fnSystem.micros() - t;
+        long encode_allocations = allocations;
+
+        size_t decoded = 0;
+        allocations = 0;
+        t = fnSystem.micros();
+        for (int r = 0; r < rounds; r++)
+            for (size_t off = 0; off < len; off += chunk)
+                decoder.feed(encoded.data() + off, len - off < chunk ? len - off : chunk,
+                    [&](const uint8_t *p, size_t n) { decoded += n; });
+        uint64_t t_decode = fnSystem.micros() - t;
+        long decode_allocations = allocations;
+        count_allocations = false;
+
+        if (decoded != size * rounds)
+            fprintf(stderr, "  decoded %zu bytes, expected %zu\n", decoded, size * rounds);
+        fprintf(stderr, "  %5zu %13.0f %12.1f %11.3f %13.0f %12.1f %11.3f\n", size,
+            per_second(rounds, t_encode), per_second(encoded_total, t_encode) / 1e6, (double)encode_allocations / rounds,
+            per_second(rounds, t_decode), per_second(decoded, t_decode) / 1e6, (double)decode_allocations / rounds);
+    }
+}
+
+// SmartPort request handling as iwm_slip does it: packet to pooled Request,
+// command bytes, Response with block data, serialized and SLIP encoded
+static void benchmark_requests()
+{
+    const int rounds = 200000;
+    const struct { const char *name; uint8_t command; size_t size; } kinds[] = {
+        {"status", SP_STATUS, 4},
+        {"readblock", SP_READ_BLOCK, 6},
+        {"writeblock", SP_WRITE_BLOCK, 6 + 512},
+    };
+
+    RequestPool pool;
+    std::vector<uint8_t> response_data;
+    std::vector<uint8_t> encoded;
+    uint8_t block[512];
+    uint8_t cmd[9];
+    for (int i = 0; i < 512; i++)
+        block[i] = (uint8_t)i;
+
+    fprintf(stderr, "SmartPort request round trips, %d per command:\n", rounds);
+    fprintf(stderr, "  command      requests/s   p50 ns   p99 ns\n");
+    for (auto &kind : kinds)
+    {
+        std::vector<uint8_t> packet(kind.size, 0);
+        packet[1] = kind.command;
+        packet[2] = 1;
+        if (kind.size > 6)
+            memcpy(packet.data() + 6, block, 512);
+
+        Histogram h;
+        uint64_t t = fnSystem.micros();
+        for (int r = 0; r < rounds; r++)
+        {
+            uint64_t t0 = nanos();
+            packet[0] = (uint8_t)r;
+            packet[3] = (uint8_t)r;
+            Request *request = pool.from_packet(packet);
+            request->create_command(cmd);
+            Response *response = request->create_response(1, 0, block, kind.command == SP_READ_BLOCK ? 512 : 4);
+            response->serialize_to(response_data);
+            SLIP::encode(response_data.data(), response_data.size(), encoded);
+            h.record(nanos() - t0);
+        }
+        uint64_t t_total = fnSystem.micros() - t;
+
+        fprintf(stderr, "  %-10s %12.0f %8llu %8llu\n", kind.name, per_second(rounds, t_total),
+            (unsigned long long)h.percentile(50.0), (unsigned long long)h.percentile(99.0));
+    }
+}
+
+// Temporary image file, every 512 byte block filled with its number
+static FILE *temp_image(uint32_t size)
+{
+    FILE *f = tmpfile();
+    if (f == nullptr)
+    {
+        fprintf(stderr, "Failed to create temporary file\n");
+        return nullptr;
+    }
+    uint8_t block[512];
+    for (uint32_t off = 0; off < size; off += sizeof(block))
+    {
+        memset(block, (uint8_t)(off / sizeof(block)), sizeof(block));
+        memcpy(block, &off, sizeof(off));
+        fwrite(block, 1, sizeof(block), f);
+    }
+    fflush(f);
+    rewind(f);
+    return f;
+}
+
+// Passes calls to wrapped file and counts them, on a remote host each is a round trip
+// Doesn't provide mmap_view(), so media types take their remote file path
+class counting_file_t : public FileHandler
+{
+public:
+    FileHandler *fh;
+    // also counted from background threads of wrapping FileHandlers
+    std::atomic<long> seeks{0};
+    std::atomic<long> reads{0};
+    std::atomic<long> writes{0};
+
+    counting_file_t(FileHandler *f) : fh(f) {}
+
+    virtual int close(bool destroy=true) override
+    {
+        int result = fh->close();
+        if (destroy) delete this;
+        return result;
+    }
+    virtual int seek(long int off, int whence) override { seeks++; return fh->seek(off, whence); }
+    virtual long int tell() override { return fh->tell(); }
+    virtual size_t read(void *ptr, size_t size, size_t n) override { reads++; return fh->read(ptr, size, n); }
+    virtual size_t write(const void *ptr, size_t size, size_t n) override { writes++; return fh->write(ptr, size, n); }
+    virtual int flush() override { return fh->flush(); }
+
+    void reset() { seeks = reads = writes = 0; }
+};
+
+// Same sequence on every platform, rand() is not
+static uint32_t lcg_next(uint32_t &state)
+{
+    state = state * 1103515245 + 12345;
+    return state >> 8;
+}
+
+// Stand-in TNFS server on loopback UDP, every path is the one image
+// Replies are sent after delay_ms, like those of a host across the internet
+class tnfs_server_t
+{
+    int _sock = -1;
+    int _delay_ms;
+    std::vector<uint8_t> _image;
+    long _position[16] = {0}; // per file handle
+    uint8_t _next_handle = 0;
+    std::atomic<bool> _stop{false};
+    std::thread _thread;
+
+    // Returns length of reply payload
+    size_t handle(uint8_t command, const uint8_t *request, int len, uint8_t *reply)
+    {
+        long size = _image.size();
+        long *position = &_position[request[0] % 16];
+        reply[0] = TNFS_RESULT_SUCCESS;
+        switch (command)
+        {
+        case TNFS_CMD_MOUNT:
+            // version 1.2, min. retry 100 ms
+            reply[1] = 0x02;
+            reply[2] = 0x01;
+            reply[3] = 100;
+            reply[4] = 0;
+            return 5;
+        case TNFS_CMD_UNMOUNT:
+        case TNFS_CMD_CLOSE:
+            return 1;
+        case TNFS_CMD_STAT:
+            memset(reply + 1, 0, 24);
+            reply[1] = 0xA4; // regular file, 0644
+            reply[2] = 0x81;
+            TNFS_UINT32_TO_LOHI_BYTEPTR(size, reply + 7);
+            return 25;
+        case TNFS_CMD_OPEN:
+            reply[1] = _next_handle++ % 16;
+            _position[reply[1]] = 0;
+            return 2;
+        case TNFS_CMD_READ:
+        {
+            long count = TNFS_UINT16_FROM_LOHI_BYTEPTR(request + 1);
+            if (*position >= size)
+            {
+                reply[0] = TNFS_RESULT_END_OF_FILE;
+                return 1;
+            }
+            if (count > size - *position)
+                count = size - *position;
+            if (count > TNFS_MAX_READWRITE_PAYLOAD)
+                count = TNFS_MAX_READWRITE_PAYLOAD;
+            reply[1] = count & 0xFF;
+            reply[2] = count >> 8;
+            memcpy(reply + 3, &_image[*position], count);
+            *position += count;
+            return 3 + count;
+        }
+        case TNFS_CMD_WRITE:
+        {
+            long count = TNFS_UINT16_FROM_LOHI_BYTEPTR(request + 1);
+            if (count > len - 3)
+                count = len - 3;
+            if (count > size - *position)
+                count = *position < size ? size - *position : 0;
+            if (count > 0)
+                memcpy(&_image[*position], request + 3, count);
+            *position += count;
+            reply[1] = count & 0xFF;
+            reply[2] = count >> 8;
+            return 3;
+        }
+        case TNFS_CMD_LSEEK:
+        {
+            long offset = (int32_t)TNFS_UINT32_FROM_LOHI_BYTEPTR(request + 2);
+            if (request[1] == SEEK_CUR)
+                offset += *position;
+            else if (request[1] == SEEK_END)
+                offset += size;
+            *position = offset;
+            TNFS_UINT32_TO_LOHI_BYTEPTR(offset, reply + 1);
+            return 5;
+        }
+        default:
+            reply[0] = TNFS_RESULT_NOT_PERMITTED;
+            return 1;
+        }
+    }
+
+    void serve()
+    {
+        uint8_t request[TNFS_HEADER_SIZE + TNFS_PAYLOAD_SIZE];
+        uint8_t reply[TNFS_HEADER_SIZE + TNFS_PAYLOAD_SIZE];
+        while (!_stop)
+        {
+            // wake up now and then to check for stop
+            fd_set readfds;
+            FD_ZERO(&readfds);
+            FD_SET(_sock, &readfds);
+            struct timeval timeout = {0, 100000};
+            if (select(_sock + 1, &readfds, nullptr, nullptr, &timeout) <= 0)
+                continue;
+
+            struct sockaddr_in from;
+            socklen_t fromlen = sizeof(from);
+            int n = recvfrom(_sock, (char *)request, sizeof(request), 0, (struct sockaddr *)&from, &fromlen);
+            if (n < TNFS_HEADER_SIZE)
+                continue;
+            requests++;
+
+            uint8_t command = request[3];
+            size_t len = handle(command, request + TNFS_HEADER_SIZE, n - TNFS_HEADER_SIZE, reply + TNFS_HEADER_SIZE);
+            memcpy(reply, request, TNFS_HEADER_SIZE);
+            if (command == TNFS_CMD_MOUNT)
+            {
+                reply[0] = 0x34; // session
+                reply[1] = 0x12;
+            }
+            if (_delay_ms)
+                std::this_thread::sleep_for(std::chrono::milliseconds(_delay_ms));
+            sendto(_sock, (const char *)reply, TNFS_HEADER_SIZE + len, 0, (struct sockaddr *)&from, fromlen);
+        }
+    }
+
+public:
+    uint16_t port = 0;
+    std::atomic<long> requests{0};
+
+    tnfs_server_t(const std::vector<uint8_t> &image, int delay_ms) : _delay_ms(delay_ms), _image(image) {}
+
+    ~tnfs_server_t()
+    {
+        _stop = true;
+        if (_thread.joinable())
+            _thread.join();
+        if (_sock >= 0)
+            closesocket(_sock);
+    }
+
+    // Returns TRUE if an error condition occurred
+    bool start(const char *address, uint16_t port)
+    {
+        _sock = socket(AF_INET, SOCK_DGRAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        addr.sin_addr.s_addr = inet_addr(address);
+        socklen_t addrlen = sizeof(addr);
+        if (bind(_sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+            getsockname(_sock, (struct sockaddr *)&addr, &addrlen) != 0)
+        {
+            fprintf(stderr, "Failed to listen on %s:%u: %s\n", address, port, compat_sockstrerror(compat_getsockerr()));
+            return true;
+        }
+        this->port = ntohs(addr.sin_port);
+        _thread = std::thread(&tnfs_server_t::serve, this);
+        return false;
+    }
+};
+
+// Whole image read in 512 byte pieces from stand-in TNFS server, by one mount and by two at once
+// Server replies at once, so READ/s is the cost of a transaction on FujiNet side
+static void benchmark_tnfsread()
+{
+    const uint32_t image_size = 8 * 1024 * 1024;
+
+    std::vector<uint8_t> image(image_size);
+    for (uint32_t b = 0; b < image_size / 512; b++)
+        memset(&image[b * 512], (uint8_t)b, 512);
+    tnfs_server_t server(image, 0);
+    if (server.start("127.0.0.1", 0))
+        return;
+
+    // Returns number of blocks which did not read back
+    auto read_image = [&]() {
+        FileSystemTNFS fs;
+        if (!fs.start("127.0.0.1", server.port))
+            return (int)(image_size / 512);
+        FileHandler *fh = fs.filehandler_open("/benchmark.img", "rb");
+        if (fh == nullptr)
+            return (int)(image_size / 512);
+        int errors = 0;
+        uint8_t block[512];
+        for (uint32_t b = 0; b < image_size / 512; b++)
+        {
+            if (fh->read(block, 1, sizeof(block)) != sizeof(block) || block[100] != (uint8_t)b)
+                errors++;
+        }
+        fh->close();
+        return errors;
+    };
+
+    fprintf(stderr, "TNFS reads of 8 MB image over loopback:\n");
+    fprintf(stderr, "  mounts     READ/s    MB/s  errors\n");
+    for (int mounts = 1; mounts <= 2; mounts++)
+    {
+        std::atomic<int> errors{0};
+        server.requests = 0;
+        uint64_t t = fnSystem.micros();
+        std::vector<std::thread> readers;
+        for (int m = 1; m < mounts; m++)
+            readers.emplace_back([&]() { errors += read_image(); });
+        errors += read_image();
+        for (auto &r : readers)
+            r.join();
+        t = fnSystem.micros() - t;
+
+        util_debug_flush();
+        fprintf(stderr, "  %6d %10.0f %7.1f %7d\n", mounts, per_second(server.requests, t),
+            per_second((uint64_t)mounts * image_size, t) / 1e6, errors.load());
+    }
+}
+
+#if defined(__linux__)
+// Computer side of a pseudo terminal serial port, sends command frames at random intervals
+// and times them until the device acknowledges
+static void uart_computer(int fd, int rounds, Histogram *h, std::atomic<bool> *done)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < rounds; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(lcg_next(seed) % 2000));
+        uint8_t cmd[5] = {0x31, 'S', 0, 0, 0x84};
+        uint64_t t = fnSystem.micros();
+        if (write(fd, cmd, sizeof(cmd)) != sizeof(cmd))
+            break;
+        struct pollfd pfd = {fd, POLLIN, 0};
+        uint8_t ack;
+        if (poll(&pfd, 1, 1000) <= 0 || read(fd, &ack, 1) != 1)
+            break;
+        h->record(fnSystem.micros() - t);
+    }
+    *done = true;
+}
+
+// Command frame to acknowledge latency over a pseudo terminal, with device polling the port
+// every 500 us and reading it directly as before, and with UARTManager and its reader thread
+static void benchmark_uart()
+{
+    const int rounds = 2000;
+
+    fprintf(stderr, "Serial command frame to ACK over pseudo terminal, %d commands:\n", rounds);
+    fprintf(stderr, "  device          p50      p95      p99      max  (us)\n");
+    for (int threaded = 0; threaded <= 1; threaded++)
+    {
+        int master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0)
+        {
+            fprintf(stderr, "Failed to open pseudo terminal: %s\n", strerror(errno));
+            return;
+        }
+        struct termios tios;
+        tcgetattr(master, &tios);
+        cfmakeraw(&tios);
+        tcsetattr(master, TCSANOW, &tios);
+
+        UARTManager uart;
+        int fd = -1;
+        if (threaded)
+        {
+            uart.set_port(ptsname(master), 0, 0);
+            uart.begin(19200);
+        }
+        else if ((fd = open(ptsname(master), O_RDWR | O_NOCTTY | O_NONBLOCK)) >= 0)
+        {
+            tcgetattr(fd, &tios);
+            cfmakeraw(&tios);
+            tcsetattr(fd, TCSANOW, &tios);
+        }
+        if (threaded ? !uart.initialized() : fd < 0)
+        {
+            fprintf(stderr, "Failed to open %s\n", ptsname(master));
+            close(master);
+            return;
+        }
+
+        Histogram h;
+        std::atomic<bool> done{false};
+        std::thread computer(uart_computer, master, rounds, &h, &done);
+        uint8_t cmd[5];
+        while (!done)
+        {
+            if (threaded)
+            {
+                if (!uart.poll(1) || uart.available() == 0)
+                    continue;
+                if (uart.readBytes(cmd, sizeof(cmd), true) == sizeof(cmd))
+                    uart.write('A');
+                continue;
+            }
+            fnSystem.delay_microseconds(500);
+            ssize_t n = read(fd, cmd, sizeof(cmd));
+            if (n <= 0)
+                continue;
+            while (n < (ssize_t)sizeof(cmd))
+            {
+                struct pollfd pfd = {fd, POLLIN, 0};
+                if (poll(&pfd, 1, 500) <= 0)
+                    break;
+                ssize_t r = read(fd, cmd + n, sizeof(cmd) - n);
+                if (r > 0)
+                    n += r;
+            }
+            if (n == sizeof(cmd) && write(fd, "A", 1) != 1)
+                break;
+        }
+        computer.join();
+        if (threaded)
+            uart.end();
+        else
+            close(fd);
+        close(master);
+
+        util_debug_flush();
+        fprintf(stderr, "  %-12s %8llu %8llu %8llu %8llu\n", threaded ? "reader" : "500 us poll",
+            (unsigned long long)h.percentile(50.0), (unsigned long long)h.percentile(95.0),
+            (unsigned long long)h.percentile(99.0), (unsigned long long)h.max());
+    }
+}
+#endif
+
+#ifdef BUILD_APPLE
+// Connected TCP sockets over loopback, emulator side gets TCP_NODELAY like FujiNet side
+// Returns TRUE if an error condition occurred
+static bool tcp_loopback_pair(int *fujinet_sock, int *peer_sock)
+{
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    socklen_t addrlen = sizeof(addr);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0 ||
+        getsockname(listener, (struct sockaddr *)&addr, &addrlen) != 0)
+    {
+        fprintf(stderr, "Failed to listen on loopback: %s\n", compat_sockstrerror(compat_getsockerr()));
+        closesocket(listener);
+        return true;
+    }
+    *fujinet_sock = socket(AF_INET, SOCK_STREAM, 0);
+    connect(*fujinet_sock, (struct sockaddr *)&addr, sizeof(addr));
+    *peer_sock = accept(listener, nullptr, nullptr);
+    closesocket(listener);
+    int nodelay = 1;
+    setsockopt(*peer_sock, IPPROTO_TCP, TCP_NODELAY, (char *)&nodelay, sizeof(nodelay));
+    return false;
+}
+
+// Emulator side of SLIP over TCP, sends a request and waits for its response
+struct slip_peer_t
+{
+    int sock;
+    uint8_t seq = 0;
+    SLIPDecoder decoder;
+    std::vector<uint8_t> encoded;
+    std::vector<uint8_t> response;
+    uint8_t buffer[TCP_READ_BUFFER_SIZE];
+
+    // Returns TRUE if an error condition occurred
+    bool request(std::initializer_list<uint8_t> packet)
+    {
+        std::vector<uint8_t> data(packet);
+        data[0] = seq++;
+        size_t len = SLIP::encode(data.data(), data.size(), encoded);
+        if (send(sock, (const char *)encoded.data(), len, 0) != (ssize_t)len)
+            return true;
+        bool done = false;
+        while (!done)
+        {
+            ssize_t n = recv(sock, (char *)buffer, sizeof(buffer), 0);
+            if (n <= 0)
+                return true;
+            decoder.feed(buffer, n, [&](const uint8_t *p, size_t size) {
+                response.assign(p, p + size);
+                done = true;
+            });
+        }
+        return false;
+    }
+};
+
+// Emulator side of SmartPort over UDP, one packet per datagram
+struct udp_peer_t
+{
+    int sock;
+    uint8_t seq = 0;
+    std::vector<uint8_t> response;
+    uint8_t buffer[UDP_MAX_DATAGRAM_SIZE];
+
+    // Returns TRUE if an error condition occurred
+    bool request(std::initializer_list<uint8_t> packet)
+    {
+        std::vector<uint8_t> data(packet);
+        data[0] = seq++;
+        if (send(sock, (const char *)data.data(), data.size(), 0) != (ssize_t)data.size())
+            return true;
+        ssize_t n;
+        // empty datagrams are address announcements
+        while ((n = recv(sock, (char *)buffer, sizeof(buffer), 0)) == 0)
+            ;
+        if (n < 0)
+            return true;
+        response.assign(buffer, buffer + n);
+        return false;
+    }
+};
+
+// FujiNet side, answers every request with four status bytes
+static void serve_status(std::shared_ptr<Connection> connection)
+{
+    RequestPool pool;
+    std::vector<uint8_t> packet;
+    std::vector<uint8_t> response_data;
+    const uint8_t status[4] = {0x80, 0, 0, 0};
+
+    while (connection->wait_for_request(packet))
+    {
+        Response *response = pool.from_packet(packet)->create_response(1, 0, status, sizeof(status));
+        response->serialize_to(response_data);
+        connection->send_data(response_data);
+    }
+}
+
+// FujiNet side, answers block reads from image like iwmDisk does
+static void serve_blocks(std::shared_ptr<TCPConnection> connection, MediaTypePO *image)
+{
+    RequestPool pool;
+    std::vector<uint8_t> packet;
+    std::vector<uint8_t> response_data;
+    std::vector<uint8_t> blocks(SLIP_READ_BLOCKS_MAX * 512);
+    uint8_t cmd[9];
+
+    while (connection->wait_for_request(packet))
+    {
+        Request *request = pool.from_packet(packet);
+        request->create_command(cmd);
+        uint32_t block_num = cmd[4] | (cmd[5] << 8) | (cmd[6] << 16);
+        Response *response;
+        if (cmd[0] == SP_STATUS && cmd[4] == SP_STATUS_SLIP_CAPS)
+        {
+            uint8_t caps[2] = {SLIP_CAP_READ_BLOCKS, SLIP_READ_BLOCKS_MAX};
+            response = request->create_response(1, 0, caps, sizeof(caps));
+        }
+        else if (cmd[0] == SP_READ_BLOCK)
+        {
+            uint16_t count = 512;
+            image->read(block_num, &count, blocks.data());
+            response = request->create_response(1, 0, blocks.data(), 512);
+        }
+        else if (cmd[0] == SP_READ_BLOCKS)
+        {
+            const uint8_t *p = image->block_ptr(block_num, cmd[7] * 512);
+            if (p == nullptr)
+            {
+                for (int i = 0; i < cmd[7]; i++)
+                {
+                    uint16_t count = 512;
+                    image->read(block_num + i, &count, blocks.data() + i * 512);
+                }
+                p = blocks.data();
+            }
+            response = request->create_response(1, 0, p, cmd[7] * 512);
+        }
+        else
+            break;
+        response->serialize_to(response_data);
+        connection->send_data(response_data);
+    }
+}
+
+// Sequential read of 8 MB file from 32 MB PO image, SLIP over loopback TCP,
+// classic READ BLOCK against READ BLOCKS if FujiNet side announces it
+static void benchmark_readblocks()
+{
+    const uint32_t image_size = 32 * 1024 * 1024;
+    const uint32_t file_start = 1000;
+    const uint32_t file_blocks = 16384;
+
+    int sock;
+    slip_peer_t peer;
+    if (tcp_loopback_pair(&sock, &peer.sock))
+        return;
+
+    FILE *f = temp_image(image_size);
+    if (f == nullptr)
+    {
+        closesocket(sock);
+        closesocket(peer.sock);
+        return;
+    }
+    MediaTypePO image;
+    image.mount(new FileHandlerLocal(f), image_size);
+
+    auto connection = std::make_shared<TCPConnection>(sock);
+    connection->set_is_connected(true);
+    connection->create_read_channel();
+    std::thread server(serve_blocks, connection, &image);
+
+    // negotiate like an emulator would
+    int max_blocks = 1;
+    if (!peer.request({0, SP_STATUS, 1, SP_STATUS_SLIP_CAPS}) && peer.response.size() == 4 &&
+        peer.response[1] == 0 && (peer.response[2] & SLIP_CAP_READ_BLOCKS))
+        max_blocks = peer.response[3];
+
+    // mount messages go out before results
+    util_debug_flush();
+    fprintf(stderr, "Reading %u blocks over loopback SLIP:\n", file_blocks);
+    fprintf(stderr, "  blocks/request  requests       MB/s\n");
+    const int per_request[] = {1, max_blocks};
+    for (int n : per_request)
+    {
+        uint64_t bytes = 0;
+        uint32_t requests = 0;
+        bool error = false;
+        uint64_t t = fnSystem.micros();
+        for (uint32_t b = file_start; b < file_start + file_blocks && !error; b += n)
+        {
+            uint8_t count = file_start + file_blocks - b < (uint32_t)n ? file_start + file_blocks - b : n;
+            if (n == 1)
+                error = peer.request({0, SP_READ_BLOCK, 1, (uint8_t)b, (uint8_t)(b >> 8), (uint8_t)(b >> 16)});
+            else
+                error = peer.request({0, SP_READ_BLOCKS, 1, (uint8_t)b, (uint8_t)(b >> 8), (uint8_t)(b >> 16), count});
+            bytes += peer.response.size() - 2;
+            requests++;
+        }
+        uint64_t t_total = fnSystem.micros() - t;
+        if (error)
+            fprintf(stderr, "  request failed\n");
+        fprintf(stderr, "  %14d %9u %10.1f\n", n, requests, per_second(bytes, t_total) / 1e6);
+    }
+
+    shutdown(peer.sock, SHUT_RDWR);
+    closesocket(peer.sock);
+    server.join();
+    connection->disconnect();
+    connection->join();
+    image.unmount();
+}
+
+// Block reads from 140 KB .DO image, sequential passes and random order
+// File calls per block are round trips when the image is on TNFS
+static void benchmark_dotracks()
+{
+    const uint32_t image_size = 35 * 4096;
+    const uint32_t blocks = image_size / 512;
+    const int reads = 4 * blocks;
+
+    fprintf(stderr, ".DO block reads, %d per pattern:\n", reads);
+    fprintf(stderr, "  pattern     seeks/block  reads/block  blocks/s at 1 ms RTT\n");
+    uint8_t buffer[512];
+    for (int pattern = 0; pattern < 2; pattern++)
+    {
+        // freshly mounted, nothing cached
+        FILE *f = temp_image(image_size);
+        if (f == nullptr)
+            return;
+        counting_file_t *file = new counting_file_t(new FileHandlerLocal(f));
+        MediaTypeDO image;
+        image.mount(file, image_size);
+        file->reset();
+
+        uint32_t state = 1;
+        for (int i = 0; i < reads; i++)
+        {
+            uint32_t block = pattern == 0 ? i % blocks : lcg_next(state) % blocks;
+            uint16_t count = sizeof(buffer);
+            if (image.read(block, &count, buffer))
+            {
+                fprintf(stderr, "  read of block %u failed\n", block);
+                break;
+            }
+        }
+        long seeks = file->seeks;
+        long file_reads = file->reads;
+        image.unmount();
+        util_debug_flush();
+        fprintf(stderr, "  %-10s %12.3f %12.3f %21.0f\n", pattern == 0 ? "sequential" : "random",
+            (double)seeks / reads, (double)file_reads / reads, reads * 1000.0 / (seeks + file_reads ? seeks + file_reads : 1));
+    }
+}
+
+// Block reads and writes of 32 MB PO image, mapped against read/write through FileHandler
+static void benchmark_poblocks()
+{
+    const uint32_t image_size = 32 * 1024 * 1024;
+    const uint32_t blocks = image_size / 512;
+    const uint32_t random_ops = 65536;
+
+    fprintf(stderr, "PO image blocks, 32 MB:\n");
+    fprintf(stderr, "  access   sequential reads/s  random reads/s  random writes/s\n");
+    uint8_t buffer[512];
+    for (int mapped = 1; mapped >= 0; mapped--)
+    {
+        FILE *f = temp_image(image_size);
+        if (f == nullptr)
+            return;
+        FileHandler *fh = new FileHandlerLocal(f);
+        if (!mapped)
+            fh = new counting_file_t(fh);
+        MediaTypePO image;
+        image.mount(fh, image_size);
+
+        bool error = false;
+        uint64_t t = fnSystem.micros();
+        for (uint32_t b = 0; b < blocks; b++)
+        {
+            uint16_t count = sizeof(buffer);
+            error |= image.read(b, &count, buffer);
+        }
+        uint64_t t_seq = fnSystem.micros() - t;
+
+        uint32_t state = 1;
+        t = fnSystem.micros();
+        for (uint32_t i = 0; i < random_ops; i++)
+        {
+            uint16_t count = sizeof(buffer);
+            error |= image.read(lcg_next(state) % blocks, &count, buffer);
+        }
+        uint64_t t_read = fnSystem.micros() - t;
+
+        t = fnSystem.micros();
+        for (uint32_t i = 0; i < random_ops; i++)
+        {
+            uint16_t count = sizeof(buffer);
+            error |= image.write(lcg_next(state) % blocks, &count, buffer);
+        }
+        image.sync();
+        uint64_t t_write = fnSystem.micros() - t;
+
+        image.unmount();
+        util_debug_flush();
+        if (error)
+            fprintf(stderr, "  block access failed\n");
+        fprintf(stderr, "  %-7s %19.0f %15.0f %16.0f\n", mapped ? "mapped" : "file",
+            per_second(blocks, t_seq), per_second(random_ops, t_read), per_second(random_ops, t_write));
+    }
+}
+
+// 35 track WOZ1 or WOZ2 image in temporary file, whole tracks on quarter tracks 0, 1 and 3
+static FILE *temp_woz(char version, uint32_t *size)
+{
+    const int tracks = 35;
+    std::vector<uint8_t> woz(256, 0);
+    memcpy(&woz[0], version == '1' ? "WOZ1" : "WOZ2", 4);
+    woz[4] = 0xFF;
+    woz[5] = 0x0A;
+    woz[6] = 0x0D;
+    woz[7] = 0x0A;
+    memcpy(&woz[12], "INFO", 4);
+    woz[16] = 60;
+    woz[20 + 39] = 32; // optimal bit timing
+    woz[20 + 44] = 13; // largest track in blocks
+    memcpy(&woz[80], "TMAP", 4);
+    woz[84] = 160;
+    for (int t = 0; t < 160; t++)
+        woz[88 + t] = t < tracks * 4 && t % 4 != 2 ? t / 4 : 0xFF;
+    memcpy(&woz[248], "TRKS", 4);
+
+    uint32_t state = 1;
+    if (version == '1')
+    {
+        uint32_t chunk = tracks * WOZ1_TRK_SIZE;
+        memcpy(&woz[252], &chunk, 4);
+        for (int t = 0; t < tracks; t++)
+        {
+            std::vector<uint8_t> trk(WOZ1_TRK_SIZE, 0);
+            uint16_t bytes_used = 6400;
+            uint16_t bit_count = bytes_used * 8;
+            for (int b = 0; b < bytes_used; b++)
+                trk[b] = (uint8_t)lcg_next(state);
+            memcpy(&trk[WOZ1_TRACK_LEN], &bytes_used, 2);
+            memcpy(&trk[WOZ1_TRACK_LEN + 2], &bit_count, 2);
+            woz.insert(woz.end(), trk.begin(), trk.end());
+        }
+    }
+    else
+    {
+        woz.resize(3 * 512, 0);
+        for (int t = 0; t < tracks; t++)
+        {
+            TRK_t trk = {(uint16_t)(3 + t * 13), 13, 13 * 512 * 8};
+            memcpy(&woz[256 + t * 8], &trk, sizeof(trk));
+        }
+        for (int b = 0; b < tracks * 13 * 512; b++)
+            woz.push_back((uint8_t)lcg_next(state));
+    }
+
+    FILE *f = tmpfile();
+    if (f == nullptr)
+    {
+        fprintf(stderr, "Failed to create temporary file\n");
+        return nullptr;
+    }
+    fwrite(woz.data(), 1, woz.size(), f);
+    fflush(f);
+    rewind(f);
+    *size = woz.size();
+    return f;
+}
+
+// WOZ mount and track access, local (WOZ2 mapped) and through counting file (remote path)
+// File calls are round trips when the image is on TNFS
+// Disk II isn't built with SMARTPORT == SLIP, this is the only caller of MediaTypeWOZ there
+static void benchmark_woz()
+{
+    fprintf(stderr, "WOZ mount and track reads, 35 track images:\n");
+    fprintf(stderr, "  image        mount ms  first track ms  calls: mount  all tracks  seeking\n");
+    for (char version : {'1', '2'})
+    {
+        for (int remote = 0; remote < 2; remote++)
+        {
+            uint32_t size;
+            FILE *f = temp_woz(version, &size);
+            if (f == nullptr)
+                return;
+            counting_file_t *file = nullptr;
+            FileHandler *fh = new FileHandlerLocal(f);
+            if (remote)
+                fh = file = new counting_file_t(fh);
+
+            MediaTypeWOZ image;
+            uint64_t t = nanos();
+            if (image.mount(fh, size) == MEDIATYPE_UNKNOWN)
+            {
+                fprintf(stderr, "  WOZ%c image not mounted\n", version);
+                fh->close();
+                return;
+            }
+            uint64_t t_mount = nanos() - t;
+            long calls_mount = remote ? file->seeks + file->reads : 0;
+            volatile uint8_t touch = image.get_track(0)[100];
+            uint64_t t_first = nanos() - t;
+
+            // every track once, then head moving back and forth over four tracks
+            long calls_before = remote ? file->seeks + file->reads : 0;
+            for (int t = 0; t < MAX_TRACKS; t++)
+                if (image.trackmap(t) != 0xFF)
+                    touch = image.get_track(t)[image.track_len(t) / 2];
+            long calls_all = remote ? file->seeks + file->reads - calls_before : 0;
+            calls_before += calls_all;
+            for (int n = 0; n < 100; n++)
+                for (int t = 40; t < 56; t++)
+                    if (image.trackmap(t) != 0xFF)
+                        touch = image.get_track(t)[0];
+            long calls_seeking = remote ? file->seeks + file->reads - calls_before : 0;
+            (void)touch;
+
+            image.unmount();
+            util_debug_flush();
+            fprintf(stderr, "  WOZ%c %-6s %9.3f %15.3f", version, remote ? "remote" : "local",
+                t_mount / 1e6, t_first / 1e6);
+            if (remote)
+                fprintf(stderr, " %12ld %11ld %8ld\n", calls_mount, calls_all, calls_seeking);
+            else
+                fprintf(stderr, " %12s %11s %8s\n", "-", "-", "-");
+        }
+    }
+}
+
+static void print_latency(const char *name, const Histogram &h)
+{
+    fprintf(stderr, "  %-9s %8.1f %8.1f %8.1f %8.1f\n", name, h.percentile(50.0) / 1000.0,
+        h.percentile(95.0) / 1000.0, h.percentile(99.0) / 1000.0, h.max() / 1000.0);
+}
+
+// STATUS round trip latency over loopback, SLIP over TCP against UDP datagrams
+static void benchmark_transport()
+{
+    const int rounds = 20000;
+
+    fprintf(stderr, "STATUS round trips over loopback, %d per transport:\n", rounds);
+    fprintf(stderr, "  transport   p50 us   p95 us   p99 us   max us\n");
+
+    int sock;
+    slip_peer_t tcp_peer;
+    if (tcp_loopback_pair(&sock, &tcp_peer.sock))
+        return;
+    auto tcp = std::make_shared<TCPConnection>(sock);
+    tcp->set_is_connected(true);
+    tcp->create_read_channel();
+    std::thread tcp_server(serve_status, tcp);
+
+    Histogram h;
+    for (int r = 0; r < rounds; r++)
+    {
+        uint64_t t = nanos();
+        if (tcp_peer.request({0, SP_STATUS, 1, 0}))
+        {
+            fprintf(stderr, "  TCP request failed\n");
+            break;
+        }
+        h.record(nanos() - t);
+    }
+    print_latency("TCP", h);
+    shutdown(tcp_peer.sock, SHUT_RDWR);
+    closesocket(tcp_peer.sock);
+    tcp_server.join();
+    tcp->disconnect();
+    tcp->join();
+
+    // FujiNet side connects to emulator, like iwm_slip does
+    udp_peer_t udp_peer;
+    udp_peer.sock = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr;
+    socklen_t addrlen = sizeof(addr);
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(udp_peer.sock, (struct sockaddr *)&addr, sizeof(addr));
+    getsockname(udp_peer.sock, (struct sockaddr *)&addr, &addrlen);
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    connect(sock, (struct sockaddr *)&addr, sizeof(addr));
+    auto udp = std::make_shared<UDPConnection>(sock);
+    udp->set_is_connected(true);
+    udp->create_read_channel();
+    std::thread udp_server(serve_status, udp);
+
+    // learn FujiNet address from its announcement
+    struct sockaddr_in from;
+    socklen_t fromlen = sizeof(from);
+    recvfrom(udp_peer.sock, (char *)udp_peer.buffer, sizeof(udp_peer.buffer), 0, (struct sockaddr *)&from, &fromlen);
+    connect(udp_peer.sock, (struct sockaddr *)&from, fromlen);
+
+    h.reset();
+    for (int r = 0; r < rounds; r++)
+    {
+        uint64_t t = nanos();
+        if (udp_peer.request({0, SP_STATUS, 1, 0}))
+        {
+            fprintf(stderr, "  UDP request failed\n");
+            break;
+        }
+        h.record(nanos() - t);
+    }
+    print_latency("UDP", h);
+    udp->disconnect();
+    udp_server.join();
+    udp->join();
+    closesocket(udp_peer.sock);
+}
+
+#if defined(__linux__)
+// Stand-in for SLIP request thread, queues requests at random intervals up to 4 ms
+template <typename Q>
+static void dispatch_requests(Q push, int count)
+{
+    uint32_t seed = 1;
+    for (int i = 0; i < count; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(lcg_next(seed) % 4000));
+        slip_request_t request;
+        request.data.assign(8, 0x41);
+        request.time = fnSystem.micros();
+        push(std::move(request));
+    }
+}
+
+static uint64_t thread_cpu_us()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_THREAD, &ru);
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000ULL + ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+
+// Service loop CPU use and request queued to picked up latency, with loop spinning on a
+// mutex protected queue as before and sleeping in event loop on MPSC queue, as iwm_slip does
+static void benchmark_dispatch()
+{
+    const int requests = 2000;
+    const uint32_t idle_ms = 1000;
+
+    fprintf(stderr, "Service loop, %d requests at 0-4 ms intervals, then %u ms idle:\n", requests, idle_ms);
+    fprintf(stderr, "  loop                    p50      p99      max  (us)  busy CPU  idle CPU\n");
+    for (int event_driven = 0; event_driven <= 1; event_driven++)
+    {
+        std::queue<slip_request_t> locked_queue;
+        std::mutex queue_mutex;
+        MpscQueue<slip_request_t> mpsc_queue;
+        std::atomic<bool> done{false};
+
+        auto pop = [&](slip_request_t &request) {
+            if (event_driven)
+                return mpsc_queue.pop(request);
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            if (locked_queue.empty())
+                return false;
+            request = std::move(locked_queue.front());
+            locked_queue.pop();
+            return true;
+        };
+        auto empty = [&]() {
+            if (event_driven)
+                return mpsc_queue.empty();
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            return locked_queue.empty();
+        };
+
+        if (event_driven)
+            fnEventLoop.begin();
+        std::thread producer([&]() {
+            if (event_driven)
+                dispatch_requests([&](slip_request_t &&r) { mpsc_queue.push(std::move(r)); fnEventLoop.wake(); }, requests);
+            else
+                dispatch_requests([&](slip_request_t &&r) { std::lock_guard<std::mutex> lock(queue_mutex); locked_queue.push(std::move(r)); }, requests);
+            done = true;
+        });
+
+        Histogram h;
+        uint64_t busy_cpu = 0, busy_us = 0, idle_cpu = 0;
+        for (int phase = 0; phase <= 1; phase++)
+        {
+            uint64_t cpu = thread_cpu_us();
+            uint64_t t = fnSystem.micros();
+            uint64_t idle_end = t + idle_ms * 1000;
+            while (phase == 0 ? !done || !empty() : fnSystem.micros() < idle_end)
+            {
+                slip_request_t request;
+                bool busy = pop(request);
+                if (busy)
+                    h.record(fnSystem.micros() - request.time);
+                // event loop is not initialized before, wait() returns at once
+                fnEventLoop.wait(busy ? 0 : EVENT_LOOP_MAX_IDLE_MS);
+            }
+            if (phase == 0)
+            {
+                busy_cpu = thread_cpu_us() - cpu;
+                busy_us = fnSystem.micros() - t;
+            }
+            else
+                idle_cpu = thread_cpu_us() - cpu;
+        }
+        producer.join();
+        if (event_driven)
+            fnEventLoop.end();
+
+        util_debug_flush();
+        fprintf(stderr, "  %-20s %8llu %8llu %8llu %13.1f%% %8.1f%%\n", event_driven ? "event loop, MPSC" : "spin, mutex queue",
+            (unsigned long long)h.percentile(50.0), (unsigned long long)h.percentile(99.0),
+            (unsigned long long)h.max(), 100.0 * busy_cpu / busy_us, 100.0 * idle_cpu / (idle_ms * 1000));
+    }
+}
+#endif
+#endif
+
+#ifdef BUILD_ATARI
+// Single density ATR image, every sector filled with its number
+static std::vector<uint8_t> atr_image(uint16_t sectors)
+{
+    std::vector<uint8_t> image(16 + sectors * 128);
+    uint16_t paragraphs = sectors * 128 / 16;
+    image[0] = 0x96;
+    image[1] = 0x02;
+    image[2] = paragraphs & 0xFF;
+    image[3] = paragraphs >> 8;
+    image[4] = 128;
+    for (uint16_t s = 1; s <= sectors; s++)
+        memset(&image[16 + (s - 1) * 128], (uint8_t)s, 128);
+    return image;
+}
+
+static FILE *temp_atr(uint16_t sectors)
+{
+    FILE *f = tmpfile();
+    if (f == nullptr)
+    {
+        fprintf(stderr, "Failed to create temporary file\n");
+        return nullptr;
+    }
+    std::vector<uint8_t> image = atr_image(sectors);
+    fwrite(image.data(), 1, image.size(), f);
+    fflush(f);
+    rewind(f);
+    return f;
+}
+
+// ATR sector read throughput with debug log off, asynchronous and synchronous
+static void benchmark_debuglog()
+{
+    const uint16_t sectors = 720;
+    const int rounds = 20;
+    const struct { const char *name; const char *levels; bool async; } modes[] = {
+        {"off", "media=0", true},
+        {"async", "media=1", true},
+        {"sync", "media=1", false}
+    };
+
+    FILE *f = temp_atr(sectors);
+    if (f == nullptr)
+        return;
+    MediaTypeATR atr;
+    if (atr.mount(new FileHandlerLocal(f), 16 + sectors * 128) != MEDIATYPE_ATR)
+    {
+        fprintf(stderr, "Failed to mount temporary ATR\n");
+        return;
+    }
+
+    std::string levels = util_debug_get_levels();
+    fprintf(stderr, "ATR sector reads, debug log:\n");
+    fprintf(stderr, "  mode     sectors/s  sectors/s incl. output\n");
+    for (auto &mode : modes)
+    {
+        util_debug_set_levels(mode.levels);
+        util_debug_set_async(mode.async);
+        uint16_t readcount;
+        uint64_t t = fnSystem.micros();
+        for (int r = 0; r < rounds; r++)
+            for (uint16_t s = 1; s <= sectors; s++)
+                atr.read(s, &readcount);
+        uint64_t t_read = fnSystem.micros() - t;
+        util_debug_flush();
+        uint64_t t_total = fnSystem.micros() - t;
+        fprintf(stderr, "  %-6s %11.0f %11.0f\n", mode.name,
+            per_second(rounds * sectors, t_read), per_second(rounds * sectors, t_total));
+    }
+    util_debug_set_async(true);
+    util_debug_set_levels(levels);
+    atr.unmount();
+}
+
+// ATR boot from stand-in TNFS server with 20 ms RTT, by read-ahead window
+// Window 1 is one sector per READ, as without cache
+static void benchmark_atrsectors()
+{
+    const uint16_t sectors = 1040;
+    const int rtt_ms = 20;
+    const int random_reads = 200;
+    const int windows[] = {1, 8, 0};
+
+    // DOS 2.5 boot: boot sectors and DOS.SYS, VTOC and directory, DUP.SYS, a BASIC program
+    std::vector<uint16_t> boot;
+    for (uint16_t s = 1; s <= 42; s++)
+        boot.push_back(s);
+    boot.push_back(360);
+    boot.push_back(1024);
+    for (uint16_t s = 361; s <= 368; s++)
+        boot.push_back(s);
+    for (uint16_t s = 43; s <= 84; s++)
+        boot.push_back(s);
+    for (uint16_t s = 85; s <= 144; s++)
+        boot.push_back(s);
+
+    std::vector<uint16_t> random;
+    uint32_t state = 1;
+    for (int i = 0; i < random_reads; i++)
+        random.push_back(lcg_next(state) % sectors + 1);
+
+    const struct { const char *name; const std::vector<uint16_t> &order; } patterns[] = {
+        {"boot", boot},
+        {"random", random},
+    };
+
+    tnfs_server_t server(atr_image(sectors), rtt_ms);
+    if (server.start("127.0.0.1", 0))
+        return;
+    FileSystemTNFS fs;
+    if (!fs.start("127.0.0.1", server.port))
+        return;
+
+    int read_ahead = Config.get_general_read_ahead();
+    fprintf(stderr, "ATR sector reads from TNFS server, %d ms RTT, 1040 sectors of 128 bytes:\n", rtt_ms);
+    fprintf(stderr, "  read_ahead  pattern  sectors  requests  requests/sector  total ms\n");
+    for (int window : windows)
+    {
+        Config.store_general_read_ahead(window);
+        for (auto &pattern : patterns)
+        {
+            FileHandler *fh = fs.filehandler_open("/benchmark.atr", "rb");
+            if (fh == nullptr)
+                break;
+            MediaTypeATR disk;
+            disk.mount(fh, 16 + sectors * 128);
+            server.requests = 0;
+
+            int errors = 0;
+            uint64_t t = fnSystem.micros();
+            for (uint16_t s : pattern.order)
+            {
+                uint16_t readcount;
+                if (disk.read(s, &readcount) || disk._disk_sectorbuff[0] != (uint8_t)s)
+                    errors++;
+            }
+            uint64_t t_read = fnSystem.micros() - t;
+
+            long requests = server.requests;
+            disk.unmount();
+            util_debug_flush();
+            if (errors)
+                fprintf(stderr, "  %d sector reads failed\n", errors);
+            char name[16];
+            snprintf(name, sizeof(name), window ? "%d" : "track", window);
+            fprintf(stderr, "  %-10s  %-7s %8zu %9ld %16.2f %9.0f\n", name, pattern.name, pattern.order.size(),
+                requests, (double)requests / pattern.order.size(), t_read / 1000.0);
+        }
+    }
+    Config.store_general_read_ahead(read_ahead);
+}
+
+// DOS copy to ATR image on stand-in TNFS server with 20 ms RTT, sector writes direct and through write-behind journal
+static void benchmark_writebehind()
+{
+    const uint16_t sectors = 720;
+    const int copy_sectors = 100;
+    const int rtt_ms = 20;
+
+    // journal on local disk, where fnSDFAT would keep it
+    FileSystemSDFAT journal_fs;
+    journal_fs.start(std::filesystem::temp_directory_path().string().c_str());
+    const char *journal_path = "/.writebehind-benchmark";
+
+    // data sectors in order, then VTOC and directory
+    std::vector<uint16_t> order;
+    for (uint16_t s = 4; s < 4 + copy_sectors; s++)
+        order.push_back(s);
+    order.push_back(360);
+    order.push_back(361);
+
+    tnfs_server_t server(atr_image(sectors), rtt_ms);
+    if (server.start("127.0.0.1", 0))
+        return;
+    FileSystemTNFS fs;
+    if (!fs.start("127.0.0.1", server.port))
+        return;
+
+    fprintf(stderr, "ATR sector writes to TNFS server, %zu sectors, %d ms RTT:\n", order.size(), rtt_ms);
+    fprintf(stderr, "  mode          writes/s   p50 ms   p99 ms    requests  unmount ms\n");
+    for (int write_behind = 0; write_behind <= 1; write_behind++)
+    {
+        FileHandler *fh = fs.filehandler_open("/benchmark.atr", "rb+");
+        if (fh == nullptr)
+            return;
+        if (write_behind)
+            fh = new FileHandlerWriteBehind(fh, &journal_fs, journal_path);
+        MediaTypeATR disk;
+        disk.mount(fh, 16 + sectors * 128);
+        server.requests = 0;
+
+        int errors = 0;
+        Histogram h;
+        uint64_t t = fnSystem.micros();
+        for (uint16_t s : order)
+        {
+            memset(disk._disk_sectorbuff, (uint8_t)~s, 128);
+            uint64_t t0 = fnSystem.micros();
+            if (disk.write(s, false))
+                errors++;
+            h.record(fnSystem.micros() - t0);
+        }
+        uint64_t t_write = fnSystem.micros() - t;
+        long requests = server.requests;
+
+        // write out of pending sectors
+        t = fnSystem.micros();
+        disk.unmount();
+        uint64_t t_unmount = fnSystem.micros() - t;
+
+        util_debug_flush();
+        if (errors)
+            fprintf(stderr, "  %d sector writes failed\n", errors);
+        fprintf(stderr, "  %-12s %9.0f %8.1f %8.1f %11ld %11.0f\n", write_behind ? "write-behind" : "direct",
+            per_second(order.size(), t_write), h.percentile(50.0) / 1000.0, h.percentile(99.0) / 1000.0,
+            requests, t_unmount / 1000.0);
+    }
+    journal_fs.remove(journal_path);
+}
+
+// ATR reads from stand-in TNFS server with 20 ms RTT, sectors read directly and from copy fetched in background
+// Reads are spaced by SIO transfer time, during which the fetch goes on
+static void benchmark_fetch()
+{
+    const uint16_t sectors = 720;
+    const int rtt_ms = 20;
+    const int sector_ms = 10;
+
+    // DOS and program, VTOC and directory, then program data near the end
+    std::vector<uint16_t> boot;
+    for (uint16_t s = 1; s <= 300; s++)
+        boot.push_back(s);
+    for (uint16_t s = 360; s <= 368; s++)
+        boot.push_back(s);
+    for (uint16_t s = 600; s <= 700; s++)
+        boot.push_back(s);
+
+    std::vector<uint16_t> random;
+    uint32_t state = 1;
+    for (int i = 0; i < 300; i++)
+        random.push_back(lcg_next(state) % sectors + 1);
+
+    const struct { const char *name; const std::vector<uint16_t> &order; } patterns[] = {
+        {"boot", boot},
+        {"random", random},
+    };
+
+    tnfs_server_t server(atr_image(sectors), rtt_ms);
+    if (server.start("127.0.0.1", 0))
+        return;
+    FileSystemTNFS fs;
+    if (!fs.start("127.0.0.1", server.port))
+        return;
+
+    fprintf(stderr, "ATR sector reads from TNFS server, %d ms RTT, %d ms per SIO sector:\n", rtt_ms, sector_ms);
+    fprintf(stderr, "  pattern  mode    sectors  first ms  read wait ms    requests\n");
+    for (auto &pattern : patterns)
+    {
+        for (int fetch = 0; fetch <= 1; fetch++)
+        {
+            FileHandler *fh = fs.filehandler_open("/benchmark.atr", "rb");
+            if (fh == nullptr)
+                return;
+            if (fetch)
+                fh = new FileHandlerFetch(fh, 16 + sectors * 128, false);
+            server.requests = 0;
+            MediaTypeATR disk;
+            disk.mount(fh, 16 + sectors * 128);
+
+            int errors = 0;
+            uint64_t t_first = 0;
+            uint64_t t_wait = 0;
+            for (uint16_t s : pattern.order)
+            {
+                uint16_t readcount;
+                uint64_t t = fnSystem.micros();
+                if (disk.read(s, &readcount) || disk._disk_sectorbuff[0] != (uint8_t)s)
+                    errors++;
+                t = fnSystem.micros() - t;
+                if (t_first == 0)
+                    t_first = t;
+                t_wait += t;
+                std::this_thread::sleep_for(std::chrono::milliseconds(sector_ms));
+            }
+            disk.unmount();
+            long requests = server.requests;
+            util_debug_flush();
+            if (errors)
+                fprintf(stderr, "  %d sector reads failed\n", errors);
+            fprintf(stderr, "  %-8s %-7s %7zu %9.1f %13.0f %11ld\n", pattern.name, fetch ? "fetch" : "direct",
+                pattern.order.size(), t_first / 1000.0, t_wait / 1000.0, requests);
+        }
+    }
+}
+
+// mount_all of the 8 drive slots spread over 3 stand-in TNFS hosts with different round trip times,
+// every host alone and all at once
+// Hosts listen on 127.0.0.2 .. 127.0.0.4 as mount_all uses the default TNFS port
+static void benchmark_mountall()
+{
+    const int delays_ms[] = {5, 20, 100};
+    const int hosts = sizeof(delays_ms) / sizeof(delays_ms[0]);
+    const char *filename = "/benchmark.atr";
+
+    std::vector<uint8_t> image = atr_image(720);
+    std::vector<std::unique_ptr<tnfs_server_t>> servers;
+    char address[16];
+    for (int h = 0; h < hosts; h++)
+    {
+        snprintf(address, sizeof(address), "127.0.0.%d", h + 2);
+        servers.emplace_back(new tnfs_server_t(image, delays_ms[h]));
+        if (servers.back()->start(address, TNFS_DEFAULT_PORT))
+            return;
+        theFuji.get_hosts(h)->set_hostname(address);
+    }
+
+    // slot goes to host slot % hosts
+    // Returns time taken by mount_all of hosts first .. last
+    auto mount = [&](int first, int last, int *slots, long *requests, int *failed) {
+        *slots = 0;
+        for (int slot = 0; slot < MAX_DISK_DEVICES; slot++)
+        {
+            int h = slot % hosts;
+            if (h < first || h > last)
+                continue;
+            fujiDisk *disk = theFuji.get_disks(slot);
+            disk->reset(filename, h, DISK_ACCESS_MODE_READ);
+            strlcpy(disk->filename, filename, sizeof(disk->filename));
+            (*slots)++;
+        }
+        for (int h = first; h <= last; h++)
+            servers[h]->requests = 0;
+
+        uint64_t t = fnSystem.micros();
+        theFuji.mount_all(false);
+        t = fnSystem.micros() - t;
+
+        *requests = 0;
+        *failed = 0;
+        for (int slot = 0; slot < MAX_DISK_DEVICES; slot++)
+        {
+            int h = slot % hosts;
+            if (h < first || h > last)
+                continue;
+            if (theFuji.get_mount_status(slot) != MOUNT_STATUS_OK)
+                (*failed)++;
+            fujiDisk *disk = theFuji.get_disks(slot);
+            disk->disk_dev.unmount();
+            disk->reset();
+        }
+        for (int h = first; h <= last; h++)
+        {
+            theFuji.get_hosts(h)->umount();
+            *requests += servers[h]->requests;
+        }
+        return t;
+    };
+
+    fprintf(stderr, "mount_all, %d drive slots on %d hosts:\n", MAX_DISK_DEVICES, hosts);
+    fprintf(stderr, "  hosts                slots  mount_all ms  requests  failed\n");
+    int slots;
+    long requests;
+    int failed;
+    uint64_t t_sum = 0;
+    for (int h = 0; h < hosts; h++)
+    {
+        uint64_t t = mount(h, h, &slots, &requests, &failed);
+        t_sum += t;
+        util_debug_flush();
+        fprintf(stderr, "  host %d, %3d ms RTT %6d %13.0f %9ld %7d\n", h + 1, delays_ms[h], slots, t / 1000.0, requests, failed);
+    }
+    fprintf(stderr, "  one after another %22.0f\n", t_sum / 1000.0);
+
+    uint64_t t = mount(0, hosts - 1, &slots, &requests, &failed);
+    util_debug_flush();
+    fprintf(stderr, "  all at once %12d %13.0f %9ld %7d\n", slots, t / 1000.0, requests, failed);
+}
+
+// Stand-in NetSIO hub on loopback UDP, plays an Atari which boots from D1:
+// sends read sector command frames and takes the data frames
+// Credit is granted one message at a time, after credit_delay_us, when the device asks for it,
+// as by a hub which schedules many emulators
+class netsio_hub_t
+{
+    int _sock = -1;
+    int _credit_delay_us;
+    struct sockaddr_in _peer;
+    bool _have_peer = false;
+    std::thread _thread;
+
+    void send_msg(std::initializer_list<uint8_t> msg)
+    {
+        std::vector<uint8_t> buf(msg);
+        sendto(_sock, (const char *)buf.data(), buf.size(), 0, (struct sockaddr *)&_peer, sizeof(_peer));
+    }
+
+    // Answers ping, alive and credit requests
+    // Returns length of next data or sync response message, 0 on timeout
+    int receive(uint8_t *msg, size_t size, int timeout_ms)
+    {
+        uint64_t deadline = fnSystem.millis() + timeout_ms;
+        while (fnSystem.millis() < deadline)
+        {
+            fd_set readfds;
+            FD_ZERO(&readfds);
+            FD_SET(_sock, &readfds);
+            struct timeval timeout = {0, 10000};
+            if (select(_sock + 1, &readfds, nullptr, nullptr, &timeout) <= 0)
+                continue;
+            socklen_t fromlen = sizeof(_peer);
+            int n = recvfrom(_sock, (char *)msg, size, 0, (struct sockaddr *)&_peer, &fromlen);
+            if (n <= 0)
+                continue;
+            _have_peer = true;
+            datagrams++;
+            switch (msg[0])
+            {
+            case NETSIO_PING_REQUEST:
+                send_msg({NETSIO_PING_RESPONSE});
+                break;
+            case NETSIO_ALIVE_REQUEST:
+                send_msg({NETSIO_ALIVE_RESPONSE});
+                break;
+            case NETSIO_CREDIT_STATUS:
+                credit_waits++;
+                std::this_thread::sleep_for(std::chrono::microseconds(_credit_delay_us));
+                send_msg({NETSIO_CREDIT_UPDATE, 1});
+                break;
+            case NETSIO_DEVICE_CONNECT:
+                connected = true;
+                break;
+            case NETSIO_DATA_BYTE:
+            case NETSIO_DATA_BLOCK:
+            case NETSIO_SYNC_RESPONSE:
+                return n;
+            default:
+                break;
+            }
+        }
+        return 0;
+    }
+
+    // Returns TRUE if an error condition occurred
+    bool read_sector(uint16_t sector, uint8_t sync)
+    {
+        uint8_t cmd[4] = {0x31, 'R', (uint8_t)(sector & 0xFF), (uint8_t)(sector >> 8)};
+        uint64_t t = fnSystem.micros();
+        unsigned chk = 0;
+        for (uint8_t b : cmd)
+            chk = ((chk + b) >> 8) + ((chk + b) & 0xFF);
+        send_msg({NETSIO_COMMAND_ON});
+        // trailing byte of data block is sequence number
+        send_msg({NETSIO_DATA_BLOCK, cmd[0], cmd[1], cmd[2], cmd[3], (uint8_t)chk, 0});
+        send_msg({NETSIO_COMMAND_OFF_SYNC, sync});
+
+        uint8_t msg[NETSIO_RX_MSG_SIZE];
+        int n;
+        do
+        {
+            if ((n = receive(msg, sizeof(msg), 1000)) == 0)
+                return true;
+        } while (msg[0] != NETSIO_SYNC_RESPONSE || n < 4 || msg[1] != sync);
+        if (msg[3] != 'A')
+            return true;
+
+        // COMPLETE, sector and checksum, in any number of messages
+        std::vector<uint8_t> frame;
+        while (frame.size() < 130)
+        {
+            if ((n = receive(msg, sizeof(msg), 1000)) == 0)
+                return true;
+            if (msg[0] == NETSIO_DATA_BYTE)
+                frame.push_back(msg[1]);
+            else if (msg[0] == NETSIO_DATA_BLOCK)
+                frame.insert(frame.end(), msg + 1, msg + n);
+        }
+        latency.record(fnSystem.micros() - t);
+        chk = 0;
+        for (int i = 1; i <= 128; i++)
+            chk = ((chk + frame[i]) >> 8) + ((chk + frame[i]) & 0xFF);
+        return frame.size() != 130 || frame[0] != 'C' || frame[1] != (uint8_t)sector || frame[129] != chk;
+    }
+
+    void boot(std::vector<uint16_t> order)
+    {
+        // device connects after ping
+        uint8_t msg[NETSIO_RX_MSG_SIZE];
+        while (!connected && !done)
+            receive(msg, sizeof(msg), 100);
+        datagrams = 0;
+        credit_waits = 0;
+
+        uint64_t t = fnSystem.micros();
+        uint8_t sync = 0;
+        for (uint16_t s : order)
+        {
+            if (done)
+                break;
+            if (read_sector(s, sync++))
+                errors++;
+        }
+        us = fnSystem.micros() - t;
+        done = true;
+    }
+
+public:
+    uint16_t port = 0;
+    std::atomic<bool> connected{false};
+    std::atomic<bool> done{false};
+    std::atomic<long> datagrams{0}; // received from device during boot
+    std::atomic<long> credit_waits{0};
+    Histogram latency; // command frame to end of data frame, per sector
+    int errors = 0;
+    uint64_t us = 0;
+
+    netsio_hub_t(int credit_delay_us) : _credit_delay_us(credit_delay_us) {}
+
+    ~netsio_hub_t()
+    {
+        done = true;
+        if (_thread.joinable())
+            _thread.join();
+        if (_sock >= 0)
+            closesocket(_sock);
+    }
+
+    // Returns TRUE if an error condition occurred
+    bool start(const std::vector<uint16_t> &order)
+    {
+        _sock = socket(AF_INET, SOCK_DGRAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        socklen_t addrlen = sizeof(addr);
+        if (bind(_sock, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+            getsockname(_sock, (struct sockaddr *)&addr, &addrlen) != 0)
+        {
+            fprintf(stderr, "Failed to listen on 127.0.0.1: %s\n", compat_sockstrerror(compat_getsockerr()));
+            return true;
+        }
+        port = ntohs(addr.sin_port);
+        _thread = std::thread(&netsio_hub_t::boot, this, order);
+        return false;
+    }
+};
+
+// Boot sectors, 1 to 200 and VTOC/directory
+static std::vector<uint16_t> netsio_boot_order()
+{
+    std::vector<uint16_t> boot;
+    for (uint16_t s = 1; s <= 200; s++)
+        boot.push_back(s);
+    for (uint16_t s = 360; s <= 368; s++)
+        boot.push_back(s);
+    return boot;
+}
+
+// Device side of ATR boot over NetSIO, does what SIO bus and disk do for a read sector command
+// Web server jobs are run between commands, as by main loop
+// Returns TRUE if an error condition occurred
+static bool netsio_boot(netsio_hub_t &hub, uint16_t sectors, bool single)
+{
+    FILE *f = temp_atr(sectors);
+    if (f == nullptr)
+        return true;
+    MediaTypeATR disk;
+    disk.mount(new FileHandlerLocal(f), 16 + sectors * 128);
+
+    // NetSIO port waits for network, loopback needs no SSID
+    if (!fnWiFi.connected())
+        fnWiFi.connect("", "");
+
+    NetSioPort port;
+    port.set_host("127.0.0.1", hub.port);
+    port.begin(SIOPORT_DEFAULT_BAUD);
+
+    while (!hub.done)
+    {
+        fnHTTPD.service();
+        if (!port.command_asserted())
+        {
+            port.poll(1);
+            continue;
+        }
+        uint8_t cmd[5];
+        if (port.read(cmd, sizeof(cmd), true) != sizeof(cmd))
+            continue;
+        while (port.command_asserted() && !hub.done)
+            port.poll(1);
+        port.write('A');
+
+        uint16_t sector = cmd[2] | (cmd[3] << 8);
+        uint16_t readcount;
+        bool err = disk.read(sector, &readcount);
+        uint8_t *buf = disk._disk_sectorbuff;
+        unsigned chk = 0;
+        for (int i = 0; i < 128; i++)
+            chk = ((chk + buf[i]) >> 8) + ((chk + buf[i]) & 0xFF);
+        if (single)
+            port.write_frame(err ? 'E' : 'C', buf, 128, (uint8_t)chk);
+        else
+            port.SioPort::write_frame(err ? 'E' : 'C', buf, 128, (uint8_t)chk);
+    }
+    port.end();
+    disk.unmount();
+    return false;
+}
+
+// ATR boot over NetSIO, COMPLETE, data frame and checksum sent as three messages and as one
+static void benchmark_netsio()
+{
+    const uint16_t sectors = 720;
+    const int credit_delay_us = 1000;
+    std::vector<uint16_t> boot = netsio_boot_order();
+
+    fprintf(stderr, "ATR boot over NetSIO, %zu sectors, %d us hub delay per credit:\n", boot.size(), credit_delay_us);
+    fprintf(stderr, "  frame          sectors/s  messages/sector  credit waits/sector  errors\n");
+    for (int single = 0; single <= 1; single++)
+    {
+        netsio_hub_t hub(credit_delay_us);
+        if (hub.start(boot) || netsio_boot(hub, sectors, single))
+            return;
+
+        util_debug_flush();
+        fprintf(stderr, "  %-12s %11.0f %16.2f %20.2f %7d\n", single ? "one message" : "three",
+            per_second(boot.size(), hub.us), (double)hub.datagrams / boot.size(),
+            (double)hub.credit_waits / boot.size(), hub.errors);
+    }
+}
+
+// Web UI client, fetches page until stopped, counts responses by status
+// Stands in for a browser on another process, which gets no more CPU than the bus thread
+static void webui_client(uint16_t port, const char *uri, std::atomic<bool> *stop, std::atomic<int> *active,
+    std::atomic<long> *ok, std::atomic<long> *failed)
+{
+#if defined(__linux__)
+    setpriority(PRIO_PROCESS, syscall(SYS_gettid), 19);
+#endif
+    std::string request = std::string("GET ") + uri + " HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\n\r\n";
+    while (!*stop)
+    {
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        addr.sin_port = htons(port);
+        std::string response;
+        if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+            send(sock, request.c_str(), request.size(), 0) == (ssize_t)request.size())
+        {
+            // server may keep connection open, read up to end of content
+            char buf[4096];
+            int n;
+            size_t end = std::string::npos;
+            while ((end == std::string::npos || response.size() < end) && (n = recv(sock, buf, sizeof(buf), 0)) > 0)
+            {
+                response.append(buf, n);
+                size_t header_end = response.find("\r\n\r\n");
+                size_t length = response.find("Content-Length: ");
+                if (end == std::string::npos && header_end != std::string::npos && length < header_end)
+                    end = header_end + 4 + strtoul(response.c_str() + length + 16, nullptr, 10);
+            }
+        }
+        closesocket(sock);
+        if (response.compare(0, 12, "HTTP/1.1 200") == 0)
+            (*ok)++;
+        else
+            (*failed)++;
+    }
+    (*active)--;
+}
+
+// SIO latency of ATR boot over NetSIO with web server idle and with clients fetching pages,
+// static file is served by web server thread only, parsed index page needs a job on bus thread
+// Pages are read from data/www as by fujinet itself
+static void benchmark_webui()
+{
+    const uint16_t sectors = 720;
+    const int clients = 4;
+    std::vector<uint16_t> boot = netsio_boot_order();
+    const struct
+    {
+        const char *name;
+        const char *uris[2]; // taken by clients in turn
+    } loads[] = {
+        {"none", {nullptr, nullptr}},
+        {"static", {"/file?favicon.ico", "/file?favicon.ico"}},
+        {"static+index", {"/file?favicon.ico", "/"}},
+    };
+
+    // free loopback port for web server
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+    socklen_t addrlen = sizeof(addr);
+    bind(sock, (struct sockaddr *)&addr, sizeof(addr));
+    getsockname(sock, (struct sockaddr *)&addr, &addrlen);
+    uint16_t port = ntohs(addr.sin_port);
+    closesocket(sock);
+
+    if (!fnWiFi.connected())
+        fnWiFi.connect("", "");
+    fsFlash.start();
+    std::string url = "http://127.0.0.1:" + std::to_string(port);
+    Config.store_general_interface_url(url.c_str());
+    fnHTTPD.start();
+    if (!fnHTTPD.running())
+    {
+        fprintf(stderr, "Failed to start web server on %s\n", url.c_str());
+        return;
+    }
+
+    fprintf(stderr, "ATR boot over NetSIO, %zu sectors, web server on %s:\n", boot.size(), url.c_str());
+    fprintf(stderr, "  web load (%d clients)  sectors/s      p50      p99      max  (us)  pages ok  failed\n", clients);
+    for (auto &load : loads)
+    {
+        std::atomic<bool> stop{false};
+        std::atomic<long> ok{0};
+        std::atomic<long> failed{0};
+        std::atomic<int> active{load.uris[0] ? clients : 0};
+        std::vector<std::thread> threads;
+        for (int i = 0; load.uris[0] && i < clients; i++)
+            threads.emplace_back(webui_client, port, load.uris[i % 2], &stop, &active, &ok, &failed);
+
+        netsio_hub_t hub(0);
+        bool err = hub.start(boot) || netsio_boot(hub, sectors, true);
+        // page requests wait for bus thread
+        stop = true;
+        while (active)
+        {
+            fnHTTPD.service();
+            fnSystem.delay(1);
+        }
+        for (auto &t : threads)
+            t.join();
+        if (err)
+            break;
+
+        util_debug_flush();
+        fprintf(stderr, "  %-20s %11.0f %8llu %8llu %8llu %15ld %7ld\n", load.name,
+            per_second(boot.size(), hub.us), (unsigned long long)hub.latency.percentile(50.0),
+            (unsigned long long)hub.latency.percentile(99.0), (unsigned long long)hub.latency.max(),
+            (long)ok, (long)failed);
+    }
+    fnHTTPD.stop();
+}
+#endif
+
+
+struct benchmark_t
+{
+    const char *name;
+    const char *description;
+    void (*run)();
+};
+
+static const benchmark_t benchmarks[] = {
+    {"delay", "delay_microseconds() jitter, sleep and precise mode", benchmark_delay},
+    {"slip", "SLIP encode/decode throughput", benchmark_slip},
+    {"requests", "SmartPort request/response handling rate", benchmark_requests},
+    {"tnfsread", "TNFS READ rate against stand-in server on loopback", benchmark_tnfsread},
+#if defined(__linux__)
+    {"uart", "serial command frame latency, 500 us polling and reader thread", benchmark_uart},
+#endif
+#ifdef BUILD_APPLE
+    {"readblocks", "READ BLOCK vs READ BLOCKS over loopback SLIP", benchmark_readblocks},
+    {"transport", "STATUS latency over loopback TCP and UDP", benchmark_transport},
+    {"dotracks", ".DO block reads, file calls per block", benchmark_dotracks},
+    {"woz", "WOZ mount time and track reads", benchmark_woz},
+    {"poblocks", "PO block access, mapped and through file", benchmark_poblocks},
+#if defined(__linux__)
+    {"dispatch", "SmartPort request dispatch latency and idle CPU, spinning and event loop", benchmark_dispatch},
+#endif
+#endif
+#ifdef BUILD_ATARI
+    {"debuglog", "ATR sector reads with debug log off, async and sync", benchmark_debuglog},
+    {"atrsectors", "ATR boot from 20 ms TNFS host by read_ahead window", benchmark_atrsectors},
+    {"writebehind", "ATR sector writes to 20 ms TNFS host, direct and write-behind", benchmark_writebehind},
+    {"fetch", "ATR boot from 20 ms TNFS host, direct and fetched copy", benchmark_fetch},
+    {"mountall", "mount_all on stand-in TNFS hosts, one by one and at once", benchmark_mountall},
+    {"netsio", "ATR boot over NetSIO, frame as three messages and as one", benchmark_netsio},
+    {"webui", "SIO latency of ATR boot over NetSIO, web UI idle and under load", benchmark_webui},
+#endif
+};
+
+
+void list_benchmarks()
+{
+    fprintf(stderr, "Benchmarks (-B name):\n");
+    for (auto &b : benchmarks)
+        fprintf(stderr, "  %-12s %s\n", b.name, b.description);
+}
+
+bool run_benchmark(const char *name)
+{
+    for (auto &b : benchmarks)
+    {
+        if (strcmp(b.name, name) == 0)
+        {
+            b.run();
+            return false;
+        }
+    }
+    return true;
+}
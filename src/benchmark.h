@@ -0,0 +1,10 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+// Benchmarks selected by -B <name>, results are printed to stderr
+
+// Returns TRUE if an error condition occurred (no benchmark of that name)
+bool run_benchmark(const char *name);
+void list_benchmarks();
+
+#endif // BENCHMARK_H
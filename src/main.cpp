@@ -25,7 +25,11 @@
 #include "httpService.h"
 
 #include "fnTaskManager.h"
+#include "fnEventLoop.h"
 #include "version.h"
+#include "histogram.h"
+#include "debug_log.h"
+#include "benchmark.h"
 
 #ifdef BLUETOOTH_SUPPORT
 #include "fnBluetooth.h"
@@ -46,6 +50,8 @@ void main_shutdown_handler()
     Debug_println("Shutdown handler called");
     // Give devices an opportunity to clean up before rebooting
 
+    // web server thread must be stopped before exit
+    fnHTTPD.stop();
     SYSTEM_BUS.shutdown();
 }
 
@@ -109,11 +115,18 @@ void main_setup(int argc, char *argv[])
 {
     // program arguments
     int opt;
-    while ((opt = getopt(argc, argv, "Vu:c:s:")) != -1) {
+    while ((opt = getopt(argc, argv, "VB:u:c:s:")) != -1) {
         switch (opt) {
             case 'V':
                 print_version();
                 exit(EXIT_SUCCESS);
+            case 'B':
+                if (run_benchmark(optarg))
+                {
+                    list_benchmarks();
+                    exit(EXIT_FAILURE);
+                }
+                exit(EXIT_SUCCESS);
             case 'u':
                 Config.store_general_interface_url(optarg);
                 break;
@@ -124,7 +137,7 @@ void main_setup(int argc, char *argv[])
                 Config.store_general_SD_path(optarg);
                 break;
             default: /* '?' */
-                fprintf(stderr, "Usage: %s [-V] [-u URL] [-c config_file] [-s SD_directory]\n", argv[0]);
+                fprintf(stderr, "Usage: %s [-V] [-B benchmark] [-u URL] [-c config_file] [-s SD_directory]\n", argv[0]);
                 exit(EXIT_FAILURE);
         }
     }
@@ -184,6 +197,9 @@ void main_setup(int argc, char *argv[])
     signal(SIGBREAK, sighandler);
 #endif
 
+    // service loop sleeps on event loop, devices register their file descriptors during setup
+    fnEventLoop.begin();
+
     fnSystem.check_hardware_ver(); // Run early to determine correct FujiNet hardware
     Debug_printf("Detected Hardware Version: %s\r\n", fnSystem.get_hardware_ver_str());
 
@@ -198,6 +214,8 @@ void main_setup(int argc, char *argv[])
 
     // Load our stored configuration
     Config.load();
+    if (!Config.get_general_debug_levels().empty())
+        util_debug_set_levels(Config.get_general_debug_levels());
 
     // Now that our main service is running, try connecting to WiFi or BlueTooth
     if (Config.get_bt_status())
@@ -431,9 +449,6 @@ void fn_service_loop(void *param)
 {
     while (!fn_shutdown)
     {
-        // We don't have any delays in this loop, so IDLE threads will be starved
-        // Shouldn't be a problem, but something to keep in mind...
-
         // Go service BT if it's active
 #ifdef BLUETOOTH_SUPPORT
         if (fnBtManager.isActive())
@@ -444,7 +459,7 @@ void fn_service_loop(void *param)
 
         fnHTTPD.service();
 
-        taskMgr.service();
+        bool idle = taskMgr.service();
 
         if (fnSystem.check_deferred_reboot())
         {
@@ -455,7 +470,16 @@ void fn_service_loop(void *param)
             // indicate to the controlling script (run-fujinet) that this program (fujinet) should be started again
             fnSystem.reboot(); // calls exit(75)
         }
+
+        // Sleep until bus port, web server or other thread needs attention
+        // or until deadline scheduled by some subsystem
+        fnEventLoop.wait(idle ? EVENT_LOOP_MAX_IDLE_MS : 0);
     }
+
+    const Histogram &lat = fnEventLoop.wake_latency();
+    Debug_printf("Event loop wake latency: count %llu, p50 %llu us, p99 %llu us, max %llu us\n",
+        (unsigned long long)lat.count(), (unsigned long long)lat.percentile(50.0),
+        (unsigned long long)lat.percentile(99.0), (unsigned long long)lat.max());
 }
 
 /*